@@ -5,10 +5,28 @@
  */
 
 #include "color_map.h"
+#include <cmath>
 #include <QSettings>
 
+namespace
+{
+// a series with continuous values would make the memo grow indefinitely
+constexpr size_t MAX_MEMO_SIZE = 4096;
+}  // namespace
+
+void ColorMap::changed()
+{
+  static uint64_t version_counter = 0;
+  _version = ++version_counter;
+  _memo.clear();
+}
+
 sol::protected_function_result ColorMap::setScrip(QString text)
 {
+  changed();
+  _table_range.reset();
+  _table.clear();
+
   _lua_function = {};
   _lua_engine = {};
   _lua_engine.open_libraries();
@@ -31,20 +49,76 @@ QString ColorMap::getError(sol::error err) const
   return QString(err.what());
 }
 
-QColor ColorMap::mapColor(double value) const
+QColor ColorMap::evaluate(double value) const
 {
   auto res = _lua_function(value);
-  if (!res.valid())
-  {
-    return Qt::transparent;
-  }
-  if (res.return_count() == 1 && res.get_type(0) == sol::type::string)
+  if (res.valid() && res.return_count() == 1 && res.get_type(0) == sol::type::string)
   {
     return QColor(res.get<std::string>(0).c_str());
   }
   return Qt::transparent;
 }
 
+QColor ColorMap::mapColor(double value) const
+{
+  if (_table_range && value >= _table_range->min && value <= _table_range->max)
+  {
+    const auto index = size_t(std::lround((value - _table_range->min) / _table_range->step));
+    return _table[std::min(index, _table.size() - 1)];
+  }
+
+  std::lock_guard<std::mutex> lock(_mutex);
+  auto memo_it = _memo.find(value);
+  if (memo_it != _memo.end())
+  {
+    return memo_it->second;
+  }
+
+  QColor color = evaluate(value);
+
+  if (_memo.size() >= MAX_MEMO_SIZE)
+  {
+    _memo.clear();
+  }
+  _memo.emplace(value, color);
+  return color;
+}
+
+bool ColorMap::compileTable(TableRange range)
+{
+  removeTable();
+
+  if (!std::isfinite(range.min) || !std::isfinite(range.max) || !(range.step > 0) ||
+      range.max < range.min)
+  {
+    return false;
+  }
+  const double count = std::floor((range.max - range.min) / range.step) + 1;
+  if (!(count <= double(MAX_TABLE_SIZE)))
+  {
+    return false;
+  }
+
+  _table.resize(size_t(count));
+  for (size_t i = 0; i < _table.size(); i++)
+  {
+    _table[i] = evaluate(range.min + double(i) * range.step);
+  }
+  _table_range = range;
+  changed();
+  return true;
+}
+
+void ColorMap::removeTable()
+{
+  if (_table_range)
+  {
+    changed();
+  }
+  _table_range.reset();
+  _table.clear();
+}
+
 std::map<QString, ColorMap::Ptr>& ColorMapLibrary()
 {
   static std::map<QString, ColorMap::Ptr> colormaps;
@@ -55,11 +129,17 @@ void SaveColorMapToSettings()
 {
   QSettings settings;
   QMap<QString, QVariant> colormap_text;
+  QMap<QString, QVariant> colormap_tables;
   for (const auto& it : ColorMapLibrary())
   {
     colormap_text.insert(it.first, it.second->script());
+    if (auto range = it.second->tableRange())
+    {
+      colormap_tables.insert(it.first, QVariantList{ range->min, range->max, range->step });
+    }
   }
   settings.setValue("ColorMapLibrary", colormap_text);
+  settings.setValue("ColorMapLibrary::tables", colormap_tables);
 }
 
 void LoadColorMapFromSettings()
@@ -69,6 +149,7 @@ void LoadColorMapFromSettings()
   ColorMapLibrary().clear();
 
   QMap<QString, QVariant> colormap_text = settings.value("ColorMapLibrary").toMap();
+  QMap<QString, QVariant> colormap_tables = settings.value("ColorMapLibrary::tables").toMap();
   for (const auto& key : colormap_text.keys())
   {
     QString script = colormap_text[key].toString();
@@ -76,6 +157,11 @@ void LoadColorMapFromSettings()
     auto res = colormap->setScrip(script);
     if (res.valid())
     {
+      QVariantList range = colormap_tables.value(key).toList();
+      if (range.size() == 3)
+      {
+        colormap->compileTable({ range[0].toDouble(), range[1].toDouble(), range[2].toDouble() });
+      }
       ColorMapLibrary().insert({ key, colormap });
     }
   }
@@ -10,6 +10,10 @@
 #include <algorithm>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 #include <QColor>
 #include <sol/sol.hpp>
 
@@ -25,14 +29,60 @@ public:
     return _script;
   }
 
+  /// The result of the script is memoized: it must depend only on the value.
+  /// Thread-safe: the plots may be rendered in parallel (see OffscreenCanvas).
   QColor mapColor(double value) const;
 
   QString getError(sol::error err) const;
 
+  struct TableRange
+  {
+    double min;
+    double max;
+    double step;
+  };
+
+  /**
+   * @brief Evaluate the script once for each value min, min+step, ..., max and store
+   * the colors in a lookup table. After that, the values in [min, max] are rounded to
+   * the nearest of them and mapped without calling Lua; the others still use the script.
+   *
+   * Use step = 1 for discrete states. Returns false, and removes the table, if the range
+   * is not valid or contains more than MAX_TABLE_SIZE values.
+   */
+  bool compileTable(TableRange range);
+
+  void removeTable();
+
+  std::optional<TableRange> tableRange() const
+  {
+    return _table_range;
+  }
+
+  static constexpr size_t MAX_TABLE_SIZE = 1 << 20;
+
+  /// Changes every time the colors might change (unique among all the ColorMaps).
+  uint64_t version() const
+  {
+    return _version;
+  }
+
 private:
   sol::state _lua_engine;
   sol::protected_function _lua_function;
   QString _script;
+  uint64_t _version = 0;
+
+  std::optional<TableRange> _table_range;
+  std::vector<QColor> _table;
+
+  // protects the Lua engine and the memo
+  mutable std::mutex _mutex;
+  mutable std::unordered_map<double, QColor> _memo;
+
+  QColor evaluate(double value) const;
+
+  void changed();
 };
 
 // Storing ColoMaps as a "singleton"
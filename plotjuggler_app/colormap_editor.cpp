@@ -57,6 +57,18 @@ void ColorMapEditor::on_buttonSave_clicked()
     return;
   }
 
+  if (ui->checkBoxTable->isChecked() &&
+      !colormap->compileTable(
+          { ui->tableMin->value(), ui->tableMax->value(), ui->tableStep->value() }))
+  {
+    QMessageBox::warning(this, "Error in the Lookup Table",
+                         tr("The range of the table is not valid, or it contains more "
+                            "than %1 values.")
+                             .arg(ColorMap::MAX_TABLE_SIZE),
+                         QMessageBox::Cancel);
+    return;
+  }
+
   QString default_name;
   auto selected = ui->listWidget->selectedItems();
   if (selected.size() == 1)
@@ -130,5 +142,21 @@ void ColorMapEditor::on_listWidget_itemDoubleClicked(QListWidgetItem* item)
   {
     auto colormap = it->second;
     ui->functionText->setText(colormap->script());
+
+    auto range = colormap->tableRange();
+    ui->checkBoxTable->setChecked(range.has_value());
+    if (range)
+    {
+      ui->tableMin->setValue(range->min);
+      ui->tableMax->setValue(range->max);
+      ui->tableStep->setValue(range->step);
+    }
   }
 }
+
+void ColorMapEditor::on_checkBoxTable_toggled(bool checked)
+{
+  ui->tableMin->setEnabled(checked);
+  ui->tableMax->setEnabled(checked);
+  ui->tableStep->setEnabled(checked);
+}
@@ -39,6 +39,8 @@ private slots:
 
   void on_listWidget_itemDoubleClicked(QListWidgetItem* item);
 
+  void on_checkBoxTable_toggled(bool checked);
+
 private:
   Ui::colormap_editor* ui;
 
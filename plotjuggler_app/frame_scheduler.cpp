@@ -0,0 +1,52 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "frame_scheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// weight of the last frame in the moving average of the durations
+constexpr double SMOOTHING = 0.2;
+}  // namespace
+
+void FrameScheduler::setFrameBudget(int budget_ms)
+{
+  _budget_ms = std::clamp(budget_ms, 1, MAX_INTERVAL_MS);
+}
+
+void FrameScheduler::startFrame()
+{
+  _frame_stage_ms.fill(0.0);
+  _stage_start = Clock::now();
+}
+
+void FrameScheduler::endStage(Stage stage)
+{
+  const auto now = Clock::now();
+  _frame_stage_ms[stage] += std::chrono::duration<double, std::milli>(now - _stage_start).count();
+  _stage_start = now;
+}
+
+void FrameScheduler::endFrame()
+{
+  for (int stage = 0; stage < STAGE_COUNT; stage++)
+  {
+    _stage_ms[stage] += SMOOTHING * (_frame_stage_ms[stage] - _stage_ms[stage]);
+  }
+}
+
+int FrameScheduler::nextInterval() const
+{
+  double frame_ms = 0;
+  for (double ms : _stage_ms)
+  {
+    frame_ms += ms;
+  }
+  const int interval = std::max(_budget_ms, int(std::ceil(2.0 * frame_ms)));
+  return std::min(interval, MAX_INTERVAL_MS);
+}
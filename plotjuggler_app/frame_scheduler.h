@@ -0,0 +1,69 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <array>
+#include <chrono>
+
+/**
+ * @brief Decides how often the plots are refreshed while streaming.
+ *
+ * The duration of each stage of a refresh is measured and smoothed. The interval
+ * between two refreshes is the frame budget, unless refreshing takes more than
+ * half of it: in that case the interval grows, so that the event loop always keeps
+ * at least half of the time to process the user input.
+ */
+class FrameScheduler
+{
+public:
+  enum Stage
+  {
+    MOVE_DATA,
+    TRANSFORMS,
+    UPDATE_CURVES,
+    PAINT,
+    STAGE_COUNT
+  };
+
+  static constexpr int DEFAULT_BUDGET_MS = 40;
+  static constexpr int MAX_INTERVAL_MS = 1000;
+
+  /// Target interval between two refreshes, in milliseconds.
+  void setFrameBudget(int budget_ms);
+
+  int frameBudget() const
+  {
+    return _budget_ms;
+  }
+
+  void startFrame();
+
+  /// The stage started when the previous one (or the frame) ended.
+  void endStage(Stage stage);
+
+  void endFrame();
+
+  /// Average duration of a stage, in milliseconds.
+  double stageTime(Stage stage) const
+  {
+    return _stage_ms[stage];
+  }
+
+  /// Interval in milliseconds to wait before the next refresh.
+  int nextInterval() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  int _budget_ms = DEFAULT_BUDGET_MS;
+  Clock::time_point _stage_start;
+  std::array<double, STAGE_COUNT> _stage_ms = {};
+  std::array<double, STAGE_COUNT> _frame_stage_ms = {};
+};
+
+#endif  // FRAME_SCHEDULER_H
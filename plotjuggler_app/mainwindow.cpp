@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <queue>
+#include <set>
 #include <stdio.h>
 
 #include <QApplication>
@@ -17,7 +18,9 @@
 #include <QDomDocument>
 #include <QDoubleSpinBox>
 #include <QElapsedTimer>
+#include <QEventLoop>
 #include <QFileDialog>
+#include <QFutureWatcher>
 #include <QInputDialog>
 #include <QMenu>
 #include <QGroupBox>
@@ -26,6 +29,7 @@
 #include <QMimeData>
 #include <QMouseEvent>
 #include <QPluginLoader>
+#include <QProgressDialog>
 #include <QPushButton>
 #include <QKeySequence>
 #include <QScrollBar>
@@ -33,16 +37,20 @@
 #include <QStringListModel>
 #include <QStringRef>
 #include <QThread>
+#include <QThreadPool>
 #include <QTextStream>
 #include <QWindow>
 #include <QHeaderView>
 #include <QStandardPaths>
 #include <QXmlStreamReader>
+#include <QtConcurrent>
 
 #include "mainwindow.h"
 #include "curvelist_panel.h"
 #include "tabbedplotwidget.h"
 #include "PlotJuggler/plotdata.h"
+#include "PlotJuggler/disk_storage.h"
+#include "PlotJuggler/chunk_compression.h"
 #include "transforms/function_editor.h"
 #include "transforms/lua_custom_function.h"
 #include "utils.h"
@@ -67,6 +75,12 @@
 #include <ament_index_cpp/get_package_share_directory.hpp>
 #endif
 
+// true if the plots of the tab are on screen
+static bool IsTabVisible(const QTabWidget* tabs, int index)
+{
+  return tabs->currentIndex() == index && tabs->isVisible();
+}
+
 MainWindow::MainWindow(const QCommandLineParser& commandline_parser, QWidget* parent)
   : QMainWindow(parent)
   , ui(new Ui::MainWindow)
@@ -91,6 +105,16 @@ MainWindow::MainWindow(const QCommandLineParser& commandline_parser, QWidget* pa
   _test_option = commandline_parser.isSet("test");
   _autostart_publishers = commandline_parser.isSet("publish");
 
+  {
+    QSettings settings;
+    bool disk_storage = settings.value("Preferences::disk_storage", false).toBool();
+    PJ::DiskStorage::instance()->setEnabled(disk_storage);
+    bool compression = settings.value("Preferences::compression", false).toBool();
+    PJ::ChunkCompression::instance()->setEnabled(compression);
+    _frame_scheduler.setFrameBudget(
+        settings.value("Preferences::frame_budget", FrameScheduler::DEFAULT_BUDGET_MS).toInt());
+  }
+
   if (commandline_parser.isSet("enabled_plugins"))
   {
     auto enabled_plugins =
@@ -676,7 +700,7 @@ void MainWindow::initializePlugins()
       if (isStreamingActive() && !_replot_timer->isActive())
       {
         _replot_timer->setSingleShot(true);
-        _replot_timer->start(40);
+        _replot_timer->start(_frame_scheduler.nextInterval());
       }
     });
 
@@ -1189,6 +1213,7 @@ void MainWindow::deleteAllData()
   forEachWidget([](PlotWidget* plot) { plot->removeAllCurves(); });
 
   _mapped_plot_data.clear();
+  _streamer_staging.clear();
   _transform_functions.clear();
   _curvelist_widget->clear();
   _loaded_datafiles_history.clear();
@@ -1255,6 +1280,155 @@ void MainWindow::importPlotDataMap(PlotDataMapRef& new_data, bool remove_old)
   }
 }
 
+void MainWindow::runBackgroundLoading(const std::vector<FileLoad*>& loads, bool remove_old,
+                                      const std::unordered_set<std::string>& imported_names)
+{
+  // interval between two updates of the plots with the new points
+  constexpr int PUBLISH_INTERVAL_MS = 250;
+  constexpr int PROGRESS_STEPS = 1000;
+  // a file may need as much memory as its size while it is read: limit how many
+  // files are read at the same time
+  constexpr int MAX_CONCURRENT_FILES = 4;
+
+  QEventLoop loop;
+  size_t finished_count = 0;
+  std::vector<std::string> error_messages(loads.size());
+  std::vector<std::unique_ptr<QFutureWatcher<void>>> watchers;
+
+  // declared after the state used by the jobs, so that it is destroyed first
+  QThreadPool pool;
+  pool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(), 1, MAX_CONCURRENT_FILES));
+
+  for (size_t i = 0; i < loads.size(); i++)
+  {
+    FileLoad* load = loads[i];
+    load->task = std::make_unique<LoadingTask>();
+    _loading_tasks.push_back(load->task.get());
+
+    std::string* error_message = &error_messages[i];
+    auto future = QtConcurrent::run(&pool, [load, error_message]() {
+      try
+      {
+        load->loaded = load->job(*load->task);
+      }
+      catch (std::exception& ex)
+      {
+        *error_message = ex.what();
+        load->loaded = false;
+      }
+    });
+    watchers.push_back(std::make_unique<QFutureWatcher<void>>());
+    connect(watchers.back().get(), &QFutureWatcher<void>::finished, &loop, [&]() {
+      if (++finished_count == loads.size())
+      {
+        loop.quit();
+      }
+    });
+    watchers.back()->setFuture(future);
+  }
+
+  // not modal: the curves loaded so far can be plotted while waiting
+  QProgressDialog progress_dialog(tr("Loading... please wait"), tr("Cancel"), 0, 0, this);
+  progress_dialog.setWindowTitle(loads.size() == 1 ? tr("Loading the file") :
+                                                     tr("Loading %1 files").arg(loads.size()));
+  progress_dialog.setWindowModality(Qt::NonModal);
+  progress_dialog.setAutoClose(false);
+  progress_dialog.setAutoReset(false);
+  connect(&progress_dialog, &QProgressDialog::canceled, this, [&loads]() {
+    for (FileLoad* load : loads)
+    {
+      load->task->cancel();
+    }
+  });
+  progress_dialog.show();
+
+  // the files imported by readFile() replaced the old series already
+  std::unordered_set<std::string> published_names = imported_names;
+
+  auto publishLoadedData = [&]() {
+    for (FileLoad* load : loads)
+    {
+      PlotDataMapRef new_data;
+      TakeStreamedData(*load->data, load->task->mutex(), new_data);
+      const std::string prefix = load->info.prefix.toStdString();
+      AddPrefixToPlotData(prefix, new_data.numeric);
+      AddPrefixToPlotData(prefix, new_data.strings);
+
+      // the old series are replaced only the first time a new one is published
+      auto registerNames = [&](auto& prev_plot_data, auto& new_plot_data) {
+        for (auto& it : new_plot_data)
+        {
+          load->added_names.insert(it.first);
+          if (!published_names.insert(it.first).second || !remove_old)
+          {
+            continue;
+          }
+          auto prev_it = prev_plot_data.find(it.first);
+          if (prev_it != prev_plot_data.end())
+          {
+            prev_it->second.clear();
+          }
+        }
+      };
+      registerNames(_mapped_plot_data.numeric, new_data.numeric);
+      registerNames(_mapped_plot_data.strings, new_data.strings);
+      registerNames(_mapped_plot_data.user_defined, new_data.user_defined);
+
+      importPlotDataMap(new_data, false);
+    }
+    _curvelist_widget->updateFilter();
+    updateDataAndReplot(true);
+  };
+
+  QTimer publish_timer;
+  connect(&publish_timer, &QTimer::timeout, this, [&]() {
+    // average of the progress of the files
+    double progress = 0;
+    bool progress_known = false;
+    for (FileLoad* load : loads)
+    {
+      auto [done, total] = load->task->progress();
+      if (total > 0)
+      {
+        progress += double(std::min(done, total)) / double(total);
+        progress_known = true;
+      }
+    }
+    if (progress_known)
+    {
+      progress_dialog.setMaximum(PROGRESS_STEPS);
+      progress_dialog.setValue(int(PROGRESS_STEPS * progress / double(loads.size())));
+    }
+    publishLoadedData();
+  });
+  publish_timer.start(PUBLISH_INTERVAL_MS);
+
+  loop.exec();
+
+  // the loop returns also when the application quits, while the jobs are running
+  for (FileLoad* load : loads)
+  {
+    load->task->cancel();
+  }
+  pool.waitForDone();
+
+  publish_timer.stop();
+  publishLoadedData();
+  progress_dialog.close();
+  _loading_tasks.clear();
+
+  for (size_t i = 0; i < loads.size(); i++)
+  {
+    if (!error_messages[i].empty())
+    {
+      QMessageBox::warning(this, tr("Exception from the plugin"),
+                           tr("The plugin [%1] thrown the following exception: \n\n %3\n")
+                               .arg(loads[i]->loader->name())
+                               .arg(QString::fromStdString(error_messages[i])));
+    }
+  }
+}
+
 bool MainWindow::isStreamingActive() const
 {
   return !ui->buttonStreamingPause->isChecked() && _active_streamer_plugin;
@@ -1262,6 +1436,12 @@ bool MainWindow::isStreamingActive() const
 
 bool MainWindow::loadDataFromFiles(QStringList filenames)
 {
+  if (!_loading_tasks.empty())
+  {
+    QMessageBox::warning(this, tr("Loading in progress"),
+                         tr("Wait until the current files are loaded, or cancel them."));
+    return false;
+  }
   filenames.sort();
   std::map<QString, QString> filename_prefix;
 
@@ -1283,6 +1463,7 @@ bool MainWindow::loadDataFromFiles(QStringList filenames)
   QStringList loaded_filenames;
   _loaded_datafiles_previous.clear();
 
+  std::vector<FileLoadInfo> infos;
   for (int i = 0; i < filenames.size(); i++)
   {
     FileLoadInfo info;
@@ -1291,7 +1472,14 @@ bool MainWindow::loadDataFromFiles(QStringList filenames)
     {
       info.prefix = filename_prefix[info.filename];
     }
-    auto added_names = loadDataFromFile(info, merge_data);
+    infos.push_back(info);
+  }
+
+  auto added_names_per_file = loadDataFromFiles(infos, merge_data);
+
+  for (int i = 0; i < filenames.size(); i++)
+  {
+    const auto& added_names = added_names_per_file[i];
     if (!added_names.empty())
     {
       loaded_filenames.push_back(filenames[i]);
@@ -1347,12 +1535,75 @@ bool MainWindow::loadDataFromFiles(QStringList filenames)
   return false;
 }
 
-std::unordered_set<std::string> MainWindow::loadDataFromFile(const FileLoadInfo& info,
-                                                             bool merge_files)
+std::vector<std::unordered_set<std::string>>
+MainWindow::loadDataFromFiles(const std::vector<FileLoadInfo>& infos, bool merge_files)
 {
+  if (!_loading_tasks.empty())
+  {
+    QMessageBox::warning(this, tr("Loading in progress"),
+                         tr("Wait until the current files are loaded, or cancel them."));
+    return std::vector<std::unordered_set<std::string>>(infos.size());
+  }
   ui->buttonPlay->setChecked(false);
 
-  const QString extension = QFileInfo(info.filename).suffix().toLower();
+  const bool remove_old = !merge_files;
+
+  // the dialogs of the loaders are shown one file at a time, then the background
+  // jobs of all the files run at the same time
+  std::vector<FileLoad> loads(infos.size());
+  std::vector<FileLoad*> background_loads;
+  std::unordered_set<std::string> imported_names;
+  for (size_t i = 0; i < infos.size(); i++)
+  {
+    loads[i].info = infos[i];
+    readFile(loads[i], remove_old);
+    if (loads[i].loaded && loads[i].job)
+    {
+      background_loads.push_back(&loads[i]);
+    }
+    else
+    {
+      imported_names.insert(loads[i].added_names.begin(), loads[i].added_names.end());
+    }
+  }
+  if (!background_loads.empty())
+  {
+    runBackgroundLoading(background_loads, remove_old, imported_names);
+  }
+
+  std::vector<std::unordered_set<std::string>> added_names;
+  for (auto& load : loads)
+  {
+    if (load.loaded)
+    {
+      registerLoadedFile(load.info);
+    }
+    added_names.push_back(std::move(load.added_names));
+  }
+
+  _curvelist_widget->updateFilter();
+
+  // clean the custom plot. Function updateDataAndReplot will update them
+  for (auto& custom_it : _transform_functions)
+  {
+    auto it = _mapped_plot_data.numeric.find(custom_it.first);
+    if (it != _mapped_plot_data.numeric.end())
+    {
+      it->second.clear();
+    }
+    custom_it.second->reset();
+  }
+  forEachWidget([](PlotWidget* plot) { plot->updateCurves(true); });
+
+  updateDataAndReplot(true);
+  ui->timeSlider->setRealValue(ui->timeSlider->getMinimum());
+
+  return added_names;
+}
+
+DataLoaderPtr MainWindow::selectDataLoader(const QString& filename)
+{
+  const QString extension = QFileInfo(filename).suffix().toLower();
 
   typedef std::map<QString, DataLoaderPtr>::const_iterator MapIterator;
 
@@ -1373,131 +1624,127 @@ std::unordered_set<std::string> MainWindow::loadDataFromFile(const FileLoadInfo&
     }
   }
 
-  DataLoaderPtr dataloader;
-  std::unordered_set<std::string> added_names;
-
   if (compatible_loaders.size() == 1)
   {
-    dataloader = compatible_loaders.front()->second;
+    return compatible_loaders.front()->second;
   }
-  else
+
+  static QString last_plugin_name_used;
+
+  QStringList names;
+  for (auto& cl : compatible_loaders)
   {
-    static QString last_plugin_name_used;
+    const auto& name = cl->first;
 
-    QStringList names;
-    for (auto& cl : compatible_loaders)
+    if (name == last_plugin_name_used)
     {
-      const auto& name = cl->first;
-
-      if (name == last_plugin_name_used)
-      {
-        names.push_front(name);
-      }
-      else
-      {
-        names.push_back(name);
-      }
+      names.push_front(name);
     }
-
-    bool ok;
-    QString plugin_name = QInputDialog::getItem(
-        this, tr("QInputDialog::getItem()"), tr("Select the loader to use:"), names, 0, false, &ok);
-    if (ok && !plugin_name.isEmpty())
+    else
     {
-      dataloader = dataLoaders().at(plugin_name);
-      last_plugin_name_used = plugin_name;
+      names.push_back(name);
     }
   }
 
-  if (dataloader)
+  bool ok;
+  QString plugin_name = QInputDialog::getItem(
+      this, tr("QInputDialog::getItem()"), tr("Select the loader to use:"), names, 0, false, &ok);
+  if (ok && !plugin_name.isEmpty())
   {
-    QFile file(info.filename);
+    last_plugin_name_used = plugin_name;
+    return dataLoaders().at(plugin_name);
+  }
+  return {};
+}
 
-    if (!file.open(QFile::ReadOnly | QFile::Text))
-    {
-      QMessageBox::warning(
-          this, tr("Datafile"),
-          tr("Cannot read file %1:\n%2.").arg(info.filename).arg(file.errorString()));
-      return {};
-    }
-    file.close();
+void MainWindow::readFile(FileLoad& load, bool remove_old)
+{
+  load.loader = selectDataLoader(load.info.filename);
+  DataLoaderPtr dataloader = load.loader;
 
-    try
-    {
-      PlotDataMapRef mapped_data;
-      FileLoadInfo new_info = info;
+  if (!dataloader)
+  {
+    QMessageBox::warning(this, tr("Error"),
+                         tr("Cannot read files with extension %1.\n No plugin can handle "
+                            "that!\n")
+                             .arg(load.info.filename));
+    return;
+  }
 
-      if (info.plugin_config.hasChildNodes())
-      {
-        dataloader->xmlLoadState(info.plugin_config.firstChildElement());
-      }
+  QFile file(load.info.filename);
 
-      if (dataloader->readDataFromFile(&new_info, mapped_data))
-      {
-        AddPrefixToPlotData(info.prefix.toStdString(), mapped_data.numeric);
-        AddPrefixToPlotData(info.prefix.toStdString(), mapped_data.strings);
+  if (!file.open(QFile::ReadOnly | QFile::Text))
+  {
+    QMessageBox::warning(
+        this, tr("Datafile"),
+        tr("Cannot read file %1:\n%2.").arg(load.info.filename).arg(file.errorString()));
+    return;
+  }
+  file.close();
 
-        added_names = mapped_data.getAllNames();
-        bool remove_old = !merge_files;
-        importPlotDataMap(mapped_data, remove_old);
+  try
+  {
+    load.data = std::make_unique<PlotDataMapRef>();
+    FileLoadInfo& new_info = load.info;
 
-        QDomElement plugin_elem = dataloader->xmlSaveState(new_info.plugin_config);
-        new_info.plugin_config.appendChild(plugin_elem);
-        _loaded_datafiles_previous.push_back(new_info);
+    if (new_info.plugin_config.hasChildNodes())
+    {
+      dataloader->xmlLoadState(new_info.plugin_config.firstChildElement());
+    }
 
-        bool duplicate = false;
+    load.loaded = dataloader->readDataFromFile(&new_info, *load.data);
+    // the loader may leave the slow part of the work to a worker thread
+    load.job = dataloader->takeBackgroundJob();
+    if (!load.loaded)
+    {
+      return;
+    }
 
-        // substitute an old item of _loaded_datafiles or push_back another item.
-        for (auto& prev_loaded : _loaded_datafiles_history)
-        {
-          if (prev_loaded.filename == new_info.filename && prev_loaded.prefix == new_info.prefix)
-          {
-            prev_loaded = new_info;
-            duplicate = true;
-            break;
-          }
-        }
+    // the same loader may read the next file before this job is executed
+    QDomElement plugin_elem = dataloader->xmlSaveState(new_info.plugin_config);
+    new_info.plugin_config.appendChild(plugin_elem);
 
-        if (!duplicate)
-        {
-          _loaded_datafiles_history.push_back(new_info);
-        }
-      }
-    }
-    catch (std::exception& ex)
+    if (!load.job)
     {
-      QMessageBox::warning(this, tr("Exception from the plugin"),
-                           tr("The plugin [%1] thrown the following exception: \n\n %3\n")
-                               .arg(dataloader->name())
-                               .arg(ex.what()));
-      return {};
+      AddPrefixToPlotData(new_info.prefix.toStdString(), load.data->numeric);
+      AddPrefixToPlotData(new_info.prefix.toStdString(), load.data->strings);
+
+      load.added_names = load.data->getAllNames();
+      importPlotDataMap(*load.data, remove_old);
     }
   }
-  else
+  catch (std::exception& ex)
   {
-    QMessageBox::warning(this, tr("Error"),
-                         tr("Cannot read files with extension %1.\n No plugin can handle "
-                            "that!\n")
-                             .arg(info.filename));
+    QMessageBox::warning(this, tr("Exception from the plugin"),
+                         tr("The plugin [%1] thrown the following exception: \n\n %3\n")
+                             .arg(dataloader->name())
+                             .arg(ex.what()));
+    load.loaded = false;
+    load.job = nullptr;
   }
-  _curvelist_widget->updateFilter();
+}
 
-  // clean the custom plot. Function updateDataAndReplot will update them
-  for (auto& custom_it : _transform_functions)
+void MainWindow::registerLoadedFile(const FileLoadInfo& new_info)
+{
+  _loaded_datafiles_previous.push_back(new_info);
+
+  bool duplicate = false;
+
+  // substitute an old item of _loaded_datafiles or push_back another item.
+  for (auto& prev_loaded : _loaded_datafiles_history)
   {
-    auto it = _mapped_plot_data.numeric.find(custom_it.first);
-    if (it != _mapped_plot_data.numeric.end())
+    if (prev_loaded.filename == new_info.filename && prev_loaded.prefix == new_info.prefix)
     {
-      it->second.clear();
+      prev_loaded = new_info;
+      duplicate = true;
+      break;
     }
-    custom_it.second->reset();
   }
-  forEachWidget([](PlotWidget* plot) { plot->updateCurves(true); });
-
-  updateDataAndReplot(true);
-  ui->timeSlider->setRealValue(ui->timeSlider->getMinimum());
 
-  return added_names;
+  if (!duplicate)
+  {
+    _loaded_datafiles_history.push_back(new_info);
+  }
 }
 
 void MainWindow::on_buttonStreamingNotifications_clicked()
@@ -1540,6 +1787,12 @@ void MainWindow::on_buttonStreamingPause_toggled(bool paused)
   }
   else
   {
+    if (_hidden_tabs_outdated)
+    {
+      forEachWidget([](PlotWidget* plot) { plot->updateCurves(false); });
+      linkedZoomOut();
+      _hidden_tabs_outdated = false;
+    }
     onUndoableChange();
   }
 }
@@ -1576,7 +1829,10 @@ void MainWindow::stopStreamingPlugin()
   if (_active_streamer_plugin)
   {
     _active_streamer_plugin->shutdown();
+    // the points published right before the plugin stopped were not moved yet
+    moveStreamedData();
     _active_streamer_plugin = nullptr;
+    updateDataAndReplot(true);
   }
 
   if (!_mapped_plot_data.numeric.empty())
@@ -1614,6 +1870,9 @@ void MainWindow::startStreamingPlugin(QString streamer_name)
     return;
   }
 
+  // points of a previous session, that was stopped before they were moved
+  _active_streamer_plugin->discardIngestedData();
+
   bool started = false;
   try
   {
@@ -1632,6 +1891,7 @@ void MainWindow::startStreamingPlugin(QString streamer_name)
   // The attempt to start the plugin may have succeeded or failed
   if (started)
   {
+    _streamer_staging.clear();
     {
       std::lock_guard<std::mutex> lock(_active_streamer_plugin->mutex());
       importPlotDataMap(_active_streamer_plugin->dataMap(), false);
@@ -1986,6 +2246,7 @@ bool MainWindow::loadLayoutFromFile(QString filename)
   QDomElement previously_loaded_datafile = root.firstChildElement("previouslyLoaded_"
                                                                   "Datafiles");
 
+  std::vector<FileLoadInfo> datafile_infos;
   QDomElement datafile_elem = previously_loaded_datafile.firstChildElement("fileInfo");
   while (!datafile_elem.isNull())
   {
@@ -2004,9 +2265,13 @@ bool MainWindow::loadLayoutFromFile(QString filename)
     auto plugin_elem = datafile_elem.firstChildElement("plugin");
     info.plugin_config.appendChild(info.plugin_config.importNode(plugin_elem, true));
 
-    loadDataFromFile(info, false);
+    datafile_infos.push_back(info);
     datafile_elem = datafile_elem.nextSiblingElement("fileInfo");
   }
+  if (!datafile_infos.empty())
+  {
+    loadDataFromFiles(datafile_infos, false);
+  }
 
   QDomElement previous_streamer = root.firstChildElement("previouslyLoaded_Streamer");
   if (!previous_streamer.isNull())
@@ -2251,6 +2516,11 @@ bool MainWindow::loadLayoutFromFile(QString filename)
 }
 
 void MainWindow::linkedZoomOut()
+{
+  linkedZoomOut([](PlotWidget*) { return true; });
+}
+
+void MainWindow::linkedZoomOut(const std::function<bool(PlotWidget*)>& filter)
 {
   if (ui->buttonLink->isChecked())
   {
@@ -2261,6 +2531,15 @@ void MainWindow::linkedZoomOut()
       {
         if (PlotDocker* matrix = dynamic_cast<PlotDocker*>(tabs->widget(t)))
         {
+          bool accepted = false;
+          for (int index = 0; index < matrix->plotCount() && !accepted; index++)
+          {
+            accepted = filter(matrix->plotAt(index));
+          }
+          if (!accepted)
+          {
+            continue;
+          }
           bool first = true;
           Range range;
           // find the ideal zoom
@@ -2305,7 +2584,12 @@ void MainWindow::linkedZoomOut()
   }
   else
   {
-    this->forEachWidget([](PlotWidget* plot) { plot->zoomOut(false); });
+    this->forEachWidget([&](PlotWidget* plot) {
+      if (filter(plot))
+      {
+        plot->zoomOut(false);
+      }
+    });
   }
 }
 
@@ -2344,6 +2628,23 @@ void MainWindow::forEachWidget(std::function<void(PlotWidget*)> op)
   forEachWidget([&](PlotWidget* plot, PlotDocker*, int) { op(plot); });
 }
 
+void MainWindow::forEachVisibleWidget(std::function<void(PlotWidget*)> op)
+{
+  for (const auto& it : TabbedPlotWidget::instances())
+  {
+    QTabWidget* tabs = it.second->tabWidget();
+    PlotDocker* matrix = dynamic_cast<PlotDocker*>(tabs->currentWidget());
+    if (!matrix || !IsTabVisible(tabs, tabs->currentIndex()))
+    {
+      continue;
+    }
+    for (int index = 0; index < matrix->plotCount(); index++)
+    {
+      op(matrix->plotAt(index));
+    }
+  }
+}
+
 void MainWindow::updateTimeSlider()
 {
   auto range = calculateVisibleRangeX();
@@ -2370,28 +2671,39 @@ void MainWindow::updateTimeOffset()
   }
 }
 
+MoveDataRet MainWindow::moveStreamedData()
+{
+  // the streamer is locked only while its points are swapped into the staging area,
+  // then they are merged without blocking the producer
+  TakeStreamedData(_active_streamer_plugin->dataMap(), _active_streamer_plugin->mutex(),
+                   _streamer_staging);
+  // batches published without any lock (see DataStreamer::publishIngestBuffer)
+  _active_streamer_plugin->consumeIngestedData(
+      [this](PlotDataMapRef& batch) { MoveData(batch, _streamer_staging, false); });
+  MoveDataRet move_ret = MoveData(_streamer_staging, _mapped_plot_data, false);
+
+  for (const auto& str : move_ret.added_curves)
+  {
+    _curvelist_widget->addCurve(str);
+  }
+
+  if (move_ret.curves_updated)
+  {
+    _curvelist_widget->refreshColumns();
+  }
+  return move_ret;
+}
+
 void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
 {
   _replot_timer->stop();
+  _frame_scheduler.startFrame();
 
   MoveDataRet move_ret;
 
   if (_active_streamer_plugin)
   {
-    {
-      std::lock_guard<std::mutex> lock(_active_streamer_plugin->mutex());
-      move_ret = MoveData(_active_streamer_plugin->dataMap(), _mapped_plot_data, false);
-    }
-
-    for (const auto& str : move_ret.added_curves)
-    {
-      _curvelist_widget->addCurve(str);
-    }
-
-    if (move_ret.curves_updated)
-    {
-      _curvelist_widget->refreshColumns();
-    }
+    move_ret = moveStreamedData();
 
     if (ui->streamingSpinBox->value() == ui->streamingSpinBox->maximum())
     {
@@ -2402,6 +2714,7 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
       _mapped_plot_data.setMaximumRangeX(ui->streamingSpinBox->value());
     }
   }
+  _frame_scheduler.endStage(FrameScheduler::MOVE_DATA);
 
   const bool is_streaming_active = isStreamingActive();
 
@@ -2426,8 +2739,34 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
       function->calculate();
     }
   }
+  _frame_scheduler.endStage(FrameScheduler::TRANSFORMS);
+
+  // a refresh of the streamed data that brought nothing new
+  if (!replot_hidden_tabs && _active_streamer_plugin && !move_ret.data_pushed)
+  {
+    _frame_scheduler.endFrame();
+    return;
+  }
 
-  forEachWidget([](PlotWidget* plot) { plot->updateCurves(false); });
+  // only the plots with new data need to be rescaled and painted again
+  std::set<PlotWidget*> updated_plots;
+  auto updatePlot = [&](PlotWidget* plot) {
+    if (plot->updateCurves(false))
+    {
+      updated_plots.insert(plot);
+    }
+  };
+  // while streaming, the plots of the hidden tabs are updated when they are shown
+  if (replot_hidden_tabs)
+  {
+    forEachWidget(updatePlot);
+  }
+  else
+  {
+    forEachVisibleWidget(updatePlot);
+  }
+  _hidden_tabs_outdated = !replot_hidden_tabs;
+  _frame_scheduler.endStage(FrameScheduler::UPDATE_CURVES);
 
   //--------------------------------
   // trigger again the execution of this callback if steaming == true
@@ -2444,7 +2783,18 @@ void MainWindow::updateDataAndReplot(bool replot_hidden_tabs)
     updateTimeSlider();
   }
   //--------------------------------
-  linkedZoomOut();
+  if (replot_hidden_tabs)
+  {
+    linkedZoomOut();
+  }
+  else
+  {
+    linkedZoomOut([&](PlotWidget* plot) { return updated_plots.count(plot) > 0; });
+  }
+  // include the parallel rendering in the duration of the frame
+  PlotWidgetBase::renderScheduledPlots();
+  _frame_scheduler.endStage(FrameScheduler::PAINT);
+  _frame_scheduler.endFrame();
 }
 
 void MainWindow::on_streamingSpinBox_valueChanged(int value)
@@ -2664,6 +3014,11 @@ void MainWindow::closeEvent(QCloseEvent* event)
   _replot_timer->stop();
   _publish_timer->stop();
 
+  for (LoadingTask* task : _loading_tasks)
+  {
+    task->cancel();
+  }
+
   if (_active_streamer_plugin)
   {
     _active_streamer_plugin->shutdown();
@@ -3259,6 +3614,13 @@ void MainWindow::on_actionPreferences_triggered()
   PreferencesDialog dialog;
   dialog.exec();
 
+  PJ::DiskStorage::instance()->setEnabled(
+      settings.value("Preferences::disk_storage", false).toBool());
+  PJ::ChunkCompression::instance()->setEnabled(
+      settings.value("Preferences::compression", false).toBool());
+  _frame_scheduler.setFrameBudget(
+      settings.value("Preferences::frame_budget", FrameScheduler::DEFAULT_BUDGET_MS).toInt());
+
   QString theme = settings.value("Preferences::theme").toString();
 
   if (!theme.isEmpty() && theme != prev_style)
@@ -3499,9 +3861,9 @@ void MainWindow::on_buttonReloadData_clicked()
 {
   const auto prev_infos = std::move(_loaded_datafiles_previous);
   _loaded_datafiles_previous.clear();
-  for (const auto& info : prev_infos)
+  if (!prev_infos.empty())
   {
-    loadDataFromFile(info, false);
+    loadDataFromFiles(prev_infos, false);
   }
   ui->buttonReloadData->setEnabled(!_loaded_datafiles_previous.empty());
 }
@@ -33,6 +33,7 @@
 #include "transforms/function_editor.h"
 #include "plugin_manager.h"
 #include "toast_manager.h"
+#include "frame_scheduler.h"
 
 #include "ui_mainwindow.h"
 
@@ -49,7 +50,10 @@ public:
 
   bool loadLayoutFromFile(QString filename);
   bool loadDataFromFiles(QStringList filenames);
-  std::unordered_set<std::string> loadDataFromFile(const FileLoadInfo& info, bool merge_files);
+  /// The background jobs of the loaders are executed in parallel (see DataLoader).
+  /// Return the names of the series of each file.
+  std::vector<std::unordered_set<std::string>>
+  loadDataFromFiles(const std::vector<FileLoadInfo>& infos, bool merge_files);
 
   void stopStreamingPlugin();
   void startStreamingPlugin(QString streamer_name);
@@ -129,6 +133,9 @@ private:
 
   PlotDataMapRef _mapped_plot_data;
 
+  // new points of the streamer, before they are merged into _mapped_plot_data
+  PlotDataMapRef _streamer_staging;
+
   TransformsMap _transform_functions;
 
   QString _default_streamer;
@@ -151,6 +158,20 @@ private:
 
   std::vector<FileLoadInfo> _loaded_datafiles_history;
   std::vector<FileLoadInfo> _loaded_datafiles_previous;
+
+  // a file read by DataLoader::readDataFromFile, whose background job may still have to run
+  struct FileLoad
+  {
+    FileLoadInfo info;
+    DataLoaderPtr loader;
+    DataLoader::BackgroundJob job;
+    std::unique_ptr<LoadingTask> task;
+    std::unique_ptr<PlotDataMapRef> data;
+    std::unordered_set<std::string> added_names;
+    bool loaded = false;
+  };
+  // the background jobs being executed, if any
+  std::vector<LoadingTask*> _loading_tasks;
   CurveTracker::Parameter _tracker_param;
 
   std::map<CurveTracker::Parameter, QIcon> _tracker_button_icons;
@@ -158,6 +179,9 @@ private:
   MonitoredValue _time_offset;
 
   QTimer* _replot_timer;
+  FrameScheduler _frame_scheduler;
+  // the plots of the hidden tabs were not updated by the last refresh
+  bool _hidden_tabs_outdated = false;
   QTimer* _publish_timer;
   PJ::DelayedCallback _tracker_delay;
 
@@ -214,6 +238,13 @@ private:
   void forEachWidget(std::function<void(PlotWidget*, PlotDocker*, int)> op);
   void forEachWidget(std::function<void(PlotWidget*)> op);
 
+  // only the plots of the current tab of each TabbedPlotWidget, if visible
+  void forEachVisibleWidget(std::function<void(PlotWidget*)> op);
+
+  // zoom out only the plots accepted by [filter]. If the zoom is linked, all the
+  // plots of the tabs that contain at least one of them.
+  void linkedZoomOut(const std::function<bool(PlotWidget*)>& filter);
+
   void rearrangeGridLayout();
 
   QDomDocument xmlSaveState() const;
@@ -223,6 +254,23 @@ private:
 
   void importPlotDataMap(PlotDataMapRef& new_data, bool remove_old);
 
+  DataLoaderPtr selectDataLoader(const QString& filename);
+
+  // Move the new points of the active streamer into _mapped_plot_data.
+  MoveDataRet moveStreamedData();
+
+  // Execute DataLoader::readDataFromFile. If the loader has no background job,
+  // the data is imported immediately.
+  void readFile(FileLoad& load, bool remove_old);
+
+  // Run the background jobs (see DataLoader::setBackgroundJob) in a pool of threads,
+  // while the points already loaded are moved into the plots. The series in
+  // [imported_names] were already imported from other files: they are never cleared.
+  void runBackgroundLoading(const std::vector<FileLoad*>& loads, bool remove_old,
+                            const std::unordered_set<std::string>& imported_names);
+
+  void registerLoadedFile(const FileLoadInfo& new_info);
+
   bool isStreamingActive() const;
 
   void closeEvent(QCloseEvent* event);
@@ -39,6 +39,7 @@ bool NlohmannParser::parseMessageImpl(double& timestamp)
   }
 
   std::function<void(const std::string&, const nlohmann::json&)> flatten;
+  size_t leaf_index = 0;
 
   flatten = [&](const std::string& prefix, const nlohmann::json& value) {
     if (value.empty())
@@ -81,8 +82,19 @@ bool NlohmannParser::parseMessageImpl(double& timestamp)
           return;
         }
 
-        auto plot_data = &(getSeries(prefix));
-        plot_data->pushBack({ timestamp, numeric_value });
+        // the leaves are usually visited in the same order in every message:
+        // comparing the name with the previous one is cheaper than a lookup
+        if (leaf_index >= _leaf_handles.size())
+        {
+          _leaf_handles.resize(leaf_index + 1, { std::string(), INVALID_SERIES_ID });
+        }
+        auto& [leaf_name, handle] = _leaf_handles[leaf_index++];
+        if (handle == INVALID_SERIES_ID || leaf_name != prefix)
+        {
+          leaf_name = prefix;
+          handle = registerSeries(prefix);
+        }
+        push(handle, timestamp, numeric_value);
 
         break;
       }
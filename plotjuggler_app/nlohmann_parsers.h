@@ -31,6 +31,8 @@ protected:
   nlohmann::json _json;
   bool _use_message_stamp;
   std::string _stamp_fieldname;
+  // name and handle of the numeric leaves, in the order they are visited
+  std::vector<std::pair<std::string, SeriesHandle>> _leaf_handles;
 };
 
 class JSON_Parser : public NlohmannParser
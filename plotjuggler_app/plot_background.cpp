@@ -7,62 +7,142 @@
 #include "plot_background.h"
 #include "qwt_scale_map.h"
 #include "qwt_painter.h"
+#include <algorithm>
 
 BackgroundColorItem::BackgroundColorItem(const PJ::PlotData& data, QString colormap_name)
   : _data(data), _data_name(QString::fromStdString(data.plotName())), _colormap_name(colormap_name)
 {
 }
 
-void BackgroundColorItem::draw(QPainter* painter, const QwtScaleMap& xMap,
-                               const QwtScaleMap& /*yMap*/, const QRectF& canvasRect) const
+void BackgroundColorItem::updateSegments(const ColorMap& colormap) const
 {
-  if (_data.size() < 2)
+  const size_t N = _data.size();
+  _segments_generation = _data.generation();
+
+  // the new points are appended if the last point scanned is still there, i.e. the
+  // data only received new points or lost the oldest ones
+  size_t index = 0;
+  if (_segments_valid && _segments_colormap_version == colormap.version() && N >= 2)
   {
-    return;
+    index = _data.lowerBoundIndex(_scan.last_x);
+    while (index < N && _data[index].x <= _scan.last_x)
+    {
+      index++;
+    }
+    if (index == 0 || _data[index - 1].x != _scan.last_x || _data[index - 1].y != _scan.last_y)
+    {
+      index = 0;
+    }
   }
-  auto it = ColorMapLibrary().find(_colormap_name);
-  if (it == ColorMapLibrary().end())
+
+  if (index > 0)
   {
-    return;
+    if (_scan.has_open_segment)
+    {
+      _segments.pop_back();
+    }
+    // remove the segments that are older than the data (front-trimming of the buffer)
+    const double front_x = _data.front().x;
+    auto first = std::find_if(_segments.begin(), _segments.end(),
+                              [front_x](const ColorSegment& seg) { return seg.max_x > front_x; });
+    _segments.erase(_segments.begin(), first);
+    if (!_segments.empty())
+    {
+      _segments.front().min_x = std::max(_segments.front().min_x, front_x);
+    }
+    _scan.open_min_x = std::max(_scan.open_min_x, front_x);
+  }
+  else
+  {
+    _segments.clear();
+    _segments_colormap_version = colormap.version();
+    _scan.has_open_segment = false;
+    // without a scan, there is nothing to append to
+    _segments_valid = (N >= 2);
+    if (!_segments_valid)
+    {
+      return;
+    }
+    const auto first = _data[0];
+    _scan.open_min_x = first.x;
+    _scan.open_color = colormap.mapColor(first.y);
+    _scan.prev_y = first.y;
+    _scan.last_x = first.x;
+    _scan.last_y = first.y;
+    index = 1;
   }
-  auto colormap = it->second;
-
-  double prev_Y = _data[0].y;
-  double min_interval = _data[0].x;
-  QColor prev_color = colormap->mapColor(prev_Y);
 
   auto isEqual = [](double a, double b) {
     return abs(a - b) < std::numeric_limits<float>::epsilon();
   };
 
-  const size_t N = _data.size();
-  double time_offset = _time_offset ? (*_time_offset) : 0;
-
-  for (size_t i = 1; i < N; i++)
+  // the last point is not scanned: it only closes the open segment
+  for (; index + 1 < N; index++)
   {
-    const auto& point = _data[i];
-    if (isEqual(prev_Y, point.y) && (i + 1) < N)
+    const auto point = _data[index];
+    _scan.last_x = point.x;
+    _scan.last_y = point.y;
+    if (isEqual(_scan.prev_y, point.y))
     {
       continue;
     }
-    QColor color = colormap->mapColor(point.y);
-    if (prev_color != color || (i + 1) == N)
+    QColor color = colormap.mapColor(point.y);
+    if (_scan.open_color != color)
     {
-      double max_interval = point.x;
-      double x1 = xMap.transform(min_interval - time_offset);
-      double x2 = xMap.transform(max_interval - time_offset);
-
-      QRectF r(x1, canvasRect.top(), x2 - x1, canvasRect.height());
-      r = r.normalized();
-
-      if (x1 < x2 && prev_color != Qt::transparent)
+      if (_scan.open_color != Qt::transparent)
       {
-        QwtPainter::fillRect(painter, r, prev_color);
+        _segments.push_back({ _scan.open_min_x, point.x, _scan.open_color });
       }
-      prev_color = color;
-      min_interval = max_interval;
+      _scan.open_color = color;
+      _scan.open_min_x = point.x;
+    }
+    _scan.prev_y = point.y;
+  }
+
+  _scan.has_open_segment = (_scan.open_color != Qt::transparent);
+  if (_scan.has_open_segment)
+  {
+    _segments.push_back({ _scan.open_min_x, _data.back().x, _scan.open_color });
+  }
+}
+
+void BackgroundColorItem::draw(QPainter* painter, const QwtScaleMap& xMap,
+                               const QwtScaleMap& /*yMap*/, const QRectF& canvasRect) const
+{
+  auto it = ColorMapLibrary().find(_colormap_name);
+  if (it == ColorMapLibrary().end())
+  {
+    return;
+  }
+  const ColorMap& colormap = *it->second;
+
+  if (!_segments_valid || _segments_generation != _data.generation() ||
+      _segments_colormap_version != colormap.version())
+  {
+    updateSegments(colormap);
+  }
+
+  const double time_offset = _time_offset ? (*_time_offset) : 0;
+  const double visible_min = std::min(xMap.s1(), xMap.s2()) + time_offset;
+  const double visible_max = std::max(xMap.s1(), xMap.s2()) + time_offset;
+
+  // the segments are sorted: skip the ones that end before the visible interval
+  auto segment = std::lower_bound(
+      _segments.begin(), _segments.end(), visible_min,
+      [](const ColorSegment& seg, double x) { return seg.max_x < x; });
+
+  for (; segment != _segments.end() && segment->min_x <= visible_max; ++segment)
+  {
+    double x1 = xMap.transform(segment->min_x - time_offset);
+    double x2 = xMap.transform(segment->max_x - time_offset);
+
+    QRectF r(x1, canvasRect.top(), x2 - x1, canvasRect.height());
+    r = r.normalized();
+
+    if (x1 < x2)
+    {
+      QwtPainter::fillRect(painter, r, segment->color);
     }
-    prev_Y = point.y;
   }
 }
 
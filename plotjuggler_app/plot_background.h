@@ -7,6 +7,7 @@
 #ifndef PLOT_BACKGROUND_H
 #define PLOT_BACKGROUND_H
 
+#include <vector>
 #include <QBrush>
 #include "qwt_plot_zoneitem.h"
 
@@ -50,6 +51,36 @@ private:
   QString _data_name;
   QString _colormap_name;
   double* _time_offset = nullptr;
+
+  // interval of time with the same color
+  struct ColorSegment
+  {
+    double min_x;
+    double max_x;
+    QColor color;
+  };
+
+  // Segments of the entire series, sorted by time. Transparent ones are skipped.
+  // They are updated only when the data or the colormap change.
+  mutable std::vector<ColorSegment> _segments;
+  mutable bool _segments_valid = false;
+  mutable uint64_t _segments_generation = 0;
+  mutable uint64_t _segments_colormap_version = 0;
+
+  // State of the scan of the data, used to append the points received while streaming.
+  // The last segment goes from open_min_x to the last point (not scanned yet).
+  struct ScanState
+  {
+    double open_min_x = 0;
+    QColor open_color;
+    double prev_y = 0;
+    double last_x = 0;
+    double last_y = 0;
+    bool has_open_segment = false;
+  };
+  mutable ScanState _scan;
+
+  void updateSegments(const ColorMap& colormap) const;
 };
 
 #endif  // PLOT_BACKGROUND_H
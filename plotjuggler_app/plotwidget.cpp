@@ -1200,16 +1200,35 @@ Range PlotWidget::getVisualizationRangeY(Range range_X) const
   return Range({ bottom, top });
 }
 
-void PlotWidget::updateCurves(bool reset_older_data)
+bool PlotWidget::updateCurves(bool reset_older_data)
 {
+  bool changed = reset_older_data;
+  std::map<const QwtSeriesWrapper*, uint64_t> generations;
+
   for (auto& it : curveList())
   {
     auto series = dynamic_cast<QwtSeriesWrapper*>(it.curve->data());
-    series->updateCache(reset_older_data);
+    const uint64_t generation = series->dataGeneration();
+    auto prev = _rendered_generations.find(series);
+    if (reset_older_data || prev == _rendered_generations.end() || prev->second != generation)
+    {
+      series->updateCache(reset_older_data);
+      changed = true;
+    }
+    generations[series] = generation;
+  }
+  // curves were removed
+  changed |= (generations.size() != _rendered_generations.size());
+  _rendered_generations.swap(generations);
+
+  if (!changed)
+  {
+    return false;
   }
   updateMaximumZoomArea();
 
   updateStatistics(true);
+  return true;
 }
 
 void PlotWidget::updateStatistics(bool forceUpdate)
@@ -107,7 +107,9 @@ signals:
 
 public slots:
 
-  void updateCurves(bool reset_older_data);
+  /// Update the curves whose data changed since the last call (all of them if
+  /// reset_older_data is true). Return false if nothing changed.
+  bool updateCurves(bool reset_older_data);
 
   void onDataSourceRemoved(const std::string& src_name);
 
@@ -237,6 +239,9 @@ private:
 
   double _tracker_position;
 
+  // PlotDataBase::generation of the data of each curve, when its cache was updated
+  std::map<const QwtSeriesWrapper*, uint64_t> _rendered_generations;
+
   Range _custom_Y_limits;
 
   TransformSelector* _transform_select_dialog;
@@ -5,8 +5,25 @@
  */
 
 #include "point_series_xy.h"
+#include <algorithm>
 #include <cmath>
-#include <cstdlib>
+#include <limits>
+
+namespace
+{
+// value of [series] at time [t], given the index of the first point not older than t
+double valueAtTime(const PlotData& series, size_t index, double t)
+{
+  const auto next = series.at(index);
+  if (next.x == t || index == 0)
+  {
+    return next.y;
+  }
+  const auto prev = series.at(index - 1);
+  const double ratio = (t - prev.x) / (next.x - prev.x);
+  return prev.y + ratio * (next.y - prev.y);
+}
+}  // namespace
 
 PointSeriesXY::PointSeriesXY(const PlotData* x_axis, const PlotData* y_axis)
   : QwtTimeseries(nullptr), _x_axis(x_axis), _y_axis(y_axis), _cached_curve("", x_axis->group())
@@ -21,17 +38,20 @@ size_t PointSeriesXY::size() const
 
 std::optional<QPointF> PointSeriesXY::sampleFromTime(double t)
 {
-  if (_cached_curve.size() == 0)
+  if (_cached_time.empty())
   {
     return {};
   }
 
-  int index = _y_axis->getIndexFromX(t);
-  if (index < 0)
+  // closest point in time
+  size_t index = size_t(std::lower_bound(_cached_time.begin(), _cached_time.end(), t) -
+                        _cached_time.begin());
+  if (index == _cached_time.size() ||
+      (index > 0 && (t - _cached_time[index - 1]) < (_cached_time[index] - t)))
   {
-    return {};
+    index--;
   }
-  const auto& p = _cached_curve.at(size_t(index));
+  const auto& p = _cached_curve.at(index);
   return QPointF(p.x, p.y);
 }
 
@@ -42,31 +62,92 @@ RangeOpt PointSeriesXY::getVisualizationRangeY(Range)
 
 void PointSeriesXY::updateCache(bool reset_old_data)
 {
-  _cached_curve.clear();
-
   if (_x_axis == nullptr)
   {
     throw std::runtime_error("the X axis is null");
   }
 
-  const size_t data_size = std::min(_x_axis->size(), _y_axis->size());
+  const PlotData& data_x = *_x_axis;
+  const PlotData& data_y = *_y_axis;
 
-  if (data_size == 0)
+  if (data_x.size() == 0 || data_y.size() == 0)
   {
+    _cached_curve.clear();
+    _cached_time.clear();
     return;
   }
 
-  const double EPS = std::numeric_limits<double>::epsilon();
+  // interval of time where both the series have data
+  const double t_start = std::max(data_x.front().x, data_y.front().x);
+  const double t_end = std::min(data_x.back().x, data_y.back().x);
+
+  // the data was replaced by older one: the points can not be appended
+  if (reset_old_data || (!_cached_time.empty() && _cached_time.back() > t_end))
+  {
+    _cached_curve.clear();
+    _cached_time.clear();
+  }
+
+  // remove the points that are older than the data (front-trimming of the buffers)
+  const size_t old_count = size_t(
+      std::lower_bound(_cached_time.begin(), _cached_time.end(), t_start) - _cached_time.begin());
+  if (old_count > 0)
+  {
+    _cached_curve.popFront(old_count);
+    _cached_time.erase(_cached_time.begin(), _cached_time.begin() + old_count);
+  }
+
+  // merge-join of the samples after the last cached point
+  size_t index_x = 0;
+  size_t index_y = 0;
+  if (_cached_time.empty())
+  {
+    index_x = data_x.lowerBoundIndex(t_start);
+    index_y = data_y.lowerBoundIndex(t_start);
+  }
+  else
+  {
+    const double last_time = _cached_time.back();
+    index_x = data_x.lowerBoundIndex(last_time);
+    index_y = data_y.lowerBoundIndex(last_time);
+    while (index_x < data_x.size() && data_x.at(index_x).x <= last_time)
+    {
+      index_x++;
+    }
+    while (index_y < data_y.size() && data_y.at(index_y).x <= last_time)
+    {
+      index_y++;
+    }
+  }
 
-  for (size_t i = 0; i < data_size; i++)
+  const double NONE = std::numeric_limits<double>::infinity();
+
+  while (true)
   {
-    if (std::abs(_x_axis->at(i).x - _y_axis->at(i).x) > EPS)
+    const double tx = (index_x < data_x.size()) ? data_x.at(index_x).x : NONE;
+    const double ty = (index_y < data_y.size()) ? data_y.at(index_y).x : NONE;
+    const double t = std::min(tx, ty);
+    if (t > t_end)
+    {
+      break;
+    }
+    const double vx = valueAtTime(data_x, index_x, t);
+    const double vy = valueAtTime(data_y, index_y, t);
+    // pushBack() skips the points that are not finite: _cached_time must do the same
+    if (std::isfinite(vx) && std::isfinite(vy))
     {
-      throw std::runtime_error("X and Y axis don't share the same time axis");
+      _cached_curve.pushBack({ vx, vy });
+      _cached_time.push_back(t);
     }
 
-    const QPointF p(_x_axis->at(i).y, _y_axis->at(i).y);
-    _cached_curve.pushBack({ p.x(), p.y() });
+    if (tx == t)
+    {
+      index_x++;
+    }
+    if (ty == t)
+    {
+      index_y++;
+    }
   }
 }
 
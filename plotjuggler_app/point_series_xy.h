@@ -7,8 +7,21 @@
 #ifndef POINT_SERIES_H
 #define POINT_SERIES_H
 
+#include <deque>
 #include "timeseries_qwt.h"
 
+/**
+ * @brief Curve with the values of one series on the X axis and of another one on the Y
+ * axis, matched by time.
+ *
+ * There is a point for each timestamp of either series, in the interval where both
+ * have data: when only one of them has a sample at that time, the value of the other
+ * is interpolated linearly.
+ *
+ * The cache is updated incrementally: the points older than the first sample of the
+ * two series are removed, and only the samples that arrived after the last cached
+ * point are added.
+ */
 class PointSeriesXY : public QwtTimeseries
 {
 public:
@@ -28,6 +41,12 @@ public:
 
   void updateCache(bool reset_old_data) override;
 
+  // both the generations never decrease: the sum changes if any of them changes
+  uint64_t dataGeneration() const override
+  {
+    return _x_axis->generation() + _y_axis->generation();
+  }
+
   RangeOpt getVisualizationRangeX() override;
 
   const PlotData* dataX() const
@@ -48,6 +67,8 @@ protected:
   const PlotData* _x_axis;
   const PlotData* _y_axis;
   PlotDataXY _cached_curve;
+  // timestamp of each point of _cached_curve
+  std::deque<double> _cached_time;
 };
 
 #endif  // POINT_SERIES_H
@@ -35,6 +35,9 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool use_opengl = settings.value("Preferences::use_opengl", true).toBool();
   ui->checkBoxOpenGL->setChecked(use_opengl);
 
+  bool parallel_rendering = settings.value("Preferences::parallel_rendering", false).toBool();
+  ui->checkBoxParallelRendering->setChecked(parallel_rendering);
+
   int precision = settings.value("Preferences::precision", 3).toInt();
   ui->comboBoxPrecision->setCurrentIndex(precision - 1);
 
@@ -70,6 +73,15 @@ PreferencesDialog::PreferencesDialog(QWidget* parent)
   bool truncation_check = settings.value("Preferences::truncation_check", true).toBool();
   ui->checkBoxTruncation->setChecked(truncation_check);
 
+  bool disk_storage = settings.value("Preferences::disk_storage", false).toBool();
+  ui->checkBoxDiskStorage->setChecked(disk_storage);
+
+  bool compression = settings.value("Preferences::compression", false).toBool();
+  ui->checkBoxCompression->setChecked(compression);
+
+  int frame_budget = settings.value("Preferences::frame_budget", 40).toInt();
+  ui->spinBoxFrameBudget->setValue(frame_budget);
+
   // Plugins
   ui->pushButtonAdd->setIcon(LoadSvg(":/resources/svg/add_tab.svg", theme));
   ui->pushButtonRemove->setIcon(LoadSvg(":/resources/svg/trash.svg", theme));
@@ -111,6 +123,8 @@ void PreferencesDialog::on_buttonBox_accepted()
   settings.setValue("Preferences::precision", ui->comboBoxPrecision->currentIndex() + 1);
   settings.setValue("Preferences::use_separator", ui->checkBoxSeparator->isChecked());
   settings.setValue("Preferences::use_opengl", ui->checkBoxOpenGL->isChecked());
+  settings.setValue("Preferences::parallel_rendering",
+                    ui->checkBoxParallelRendering->isChecked());
   settings.setValue("Preferences::no_splash", ui->checkBoxSkipSplash->isChecked());
   settings.setValue("Preferences::autozoom_visibility",
                     ui->checkBoxAutoZoomVisibility->isChecked());
@@ -118,6 +132,9 @@ void PreferencesDialog::on_buttonBox_accepted()
   settings.setValue("Preferences::autozoom_filter_applied",
                     ui->checkBoxAutoZoomFilter->isChecked());
   settings.setValue("Preferences::truncation_check", ui->checkBoxTruncation->isChecked());
+  settings.setValue("Preferences::disk_storage", ui->checkBoxDiskStorage->isChecked());
+  settings.setValue("Preferences::compression", ui->checkBoxCompression->isChecked());
+  settings.setValue("Preferences::frame_budget", ui->spinBoxFrameBudget->value());
   settings.setValue("Preferences::export_plot_size",
                     QSize{ ui->spinBoxExportX->value(), ui->spinBoxExportY->value() });
   settings.setValue("Preferences::swap_pan_zoom", ui->checkBoxSwapPanZoom->isChecked());
@@ -293,6 +293,11 @@ void TabbedPlotWidget::on_tabWidget_currentChanged(int index)
   PlotDocker* tab = dynamic_cast<PlotDocker*>(tabWidget()->widget(index));
   if (tab)
   {
+    // the plots of the hidden tabs are not updated while streaming
+    for (int i = 0; i < tab->plotCount(); i++)
+    {
+      tab->plotAt(i)->updateCurves(false);
+    }
     tab->replot();
   }
   for (int i = 0; i < tabWidget()->count(); i++)
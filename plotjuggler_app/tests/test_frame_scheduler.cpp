@@ -0,0 +1,75 @@
+#include "frame_scheduler.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+void runFrame(FrameScheduler& scheduler, std::chrono::milliseconds paint_time)
+{
+  scheduler.startFrame();
+  scheduler.endStage(FrameScheduler::MOVE_DATA);
+  scheduler.endStage(FrameScheduler::TRANSFORMS);
+  scheduler.endStage(FrameScheduler::UPDATE_CURVES);
+  std::this_thread::sleep_for(paint_time);
+  scheduler.endStage(FrameScheduler::PAINT);
+  scheduler.endFrame();
+}
+}  // namespace
+
+TEST(FrameScheduler, BudgetIsClamped)
+{
+  FrameScheduler scheduler;
+  EXPECT_EQ(scheduler.frameBudget(), FrameScheduler::DEFAULT_BUDGET_MS);
+
+  scheduler.setFrameBudget(0);
+  EXPECT_EQ(scheduler.frameBudget(), 1);
+  scheduler.setFrameBudget(-10);
+  EXPECT_EQ(scheduler.frameBudget(), 1);
+  scheduler.setFrameBudget(5000);
+  EXPECT_EQ(scheduler.frameBudget(), FrameScheduler::MAX_INTERVAL_MS);
+  scheduler.setFrameBudget(25);
+  EXPECT_EQ(scheduler.frameBudget(), 25);
+}
+
+TEST(FrameScheduler, IntervalIsTheBudgetWithoutFrames)
+{
+  FrameScheduler scheduler;
+  EXPECT_EQ(scheduler.nextInterval(), FrameScheduler::DEFAULT_BUDGET_MS);
+  scheduler.setFrameBudget(100);
+  EXPECT_EQ(scheduler.nextInterval(), 100);
+  for (int stage = 0; stage < FrameScheduler::STAGE_COUNT; stage++)
+  {
+    EXPECT_EQ(scheduler.stageTime(FrameScheduler::Stage(stage)), 0.0);
+  }
+}
+
+TEST(FrameScheduler, FastFramesKeepTheBudget)
+{
+  FrameScheduler scheduler;
+  scheduler.setFrameBudget(200);
+  for (int i = 0; i < 5; i++)
+  {
+    runFrame(scheduler, std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(scheduler.nextInterval(), 200);
+}
+
+TEST(FrameScheduler, SlowFramesIncreaseTheInterval)
+{
+  FrameScheduler scheduler;
+  scheduler.setFrameBudget(10);
+  for (int i = 0; i < 15; i++)
+  {
+    runFrame(scheduler, std::chrono::milliseconds(20));
+  }
+  // the measured time is in the stage that was slow
+  EXPECT_GT(scheduler.stageTime(FrameScheduler::PAINT), 15.0);
+  EXPECT_LT(scheduler.stageTime(FrameScheduler::MOVE_DATA), 5.0);
+
+  // at least half of the interval is left to the event loop
+  const int interval = scheduler.nextInterval();
+  EXPECT_GE(interval, int(2.0 * scheduler.stageTime(FrameScheduler::PAINT)));
+  EXPECT_GT(interval, 30);
+  EXPECT_LE(interval, FrameScheduler::MAX_INTERVAL_MS);
+}
@@ -58,6 +58,7 @@ void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_
   std::unique_lock<std::mutex> lk(mutex_);
 
   _chan_values.resize(src_data.size());
+  _chan_cursors.resize(src_data.size(), 0);
 
   const PlotData::Point& old_point = src_data.front()->at(point_index);
 
@@ -65,7 +66,7 @@ void LuaCustomFunction::calculatePoints(const std::vector<const PlotData*>& src_
   {
     double value;
     const PlotData* chan_data = src_data[chan_index];
-    int index = chan_data->getIndexFromX(old_point.x);
+    int index = chan_data->getIndexFromX(old_point.x, _chan_cursors[chan_index]);
     if (index != -1)
     {
       value = chan_data->at(index).y;
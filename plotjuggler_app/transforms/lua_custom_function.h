@@ -34,6 +34,8 @@ private:
   sol::state _lua_engine;
   sol::protected_function _lua_function;
   std::vector<double> _chan_values;
+  // points are calculated in order: resume the search of each channel from the last index
+  std::vector<size_t> _chan_cursors;
   std::mutex mutex_;
   int global_lines_ = 0;
   int function_lines_ = 0;
@@ -6,6 +6,10 @@
 
 #include "utils.h"
 #include <QDebug>
+#include <QtConcurrent>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace PJ
 {
@@ -22,7 +26,7 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
   }
   if (dst_plot.size() == 0)
   {
-    std::swap(dst_plot, src_plot);
+    dst_plot.clonePoints(std::move(src_plot));
     return;
   }
 
@@ -30,50 +34,56 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
   if (dst_plot.size() == src_plot.size() && isEqual(dst_plot.back().x, src_plot.back().x) &&
       isEqual(dst_plot.front().x, src_plot.front().x))
   {
-    bool need_sorting = false;
-    for (size_t i = 0; i < src_plot.size(); i++)
+    // the result is built in bulk and swapped in, instead of being written point by
+    // point: the sealed chunks are packed again, as in any other series
+    const size_t count = src_plot.size();
+    std::vector<double> merged_x;
+    std::vector<Value> merged_y;
+    std::vector<double> extra_x;
+    std::vector<Value> extra_y;
+    merged_x.reserve(count);
+    merged_y.reserve(count);
+    for (size_t i = 0; i < count; i++)
     {
-      auto& src_point = src_plot[i];
-      auto& dst_point = dst_plot[i];
+      const auto src_point = std::as_const(src_plot)[i];
+      const auto dst_point = std::as_const(dst_plot)[i];
+      merged_x.push_back(dst_point.x);
       if (isEqual(src_point.x, dst_point.x))
       {
         // update only
-        dst_point.y = src_point.y;
+        merged_y.push_back(src_point.y);
       }
       else
       {
-        dst_plot.pushUnsorted(std::move(src_point));
-        need_sorting = true;
+        merged_y.push_back(dst_point.y);
+        extra_x.push_back(src_point.x);
+        extra_y.push_back(src_point.y);
       }
     }
     src_plot.clear();
-    if (need_sorting)
-    {
-      dst_plot.sort();
-    }
+
+    TimeseriesBase<Value> merged(dst_plot.plotName(), dst_plot.group());
+    merged.setValueType(dst_plot.valueType());
+    merged.appendSorted(merged_x.data(), merged_y.data(), merged_x.size());
+    merged.appendUnsorted(extra_x.data(), extra_y.data(), extra_x.size());
+    dst_plot.clonePoints(std::move(merged));
     return;
   }
 
-  // append
+  // append: the chunks of points are moved, if possible
   if (dst_plot.back().x < src_plot.front().x)
   {
-    for (size_t i = 0; i < src_plot.size(); i++)
-    {
-      dst_plot.pushBack(std::move(src_plot.at(i)));
-    }
-    src_plot.clear();
+    dst_plot.splicePoints(std::move(src_plot));
     return;
   }
   // prepend
   if (src_plot.back().x < dst_plot.front().x)
   {
-    // swap and append
-    std::swap(dst_plot, src_plot);
-    for (size_t i = 0; i < src_plot.size(); i++)
-    {
-      dst_plot.pushBack(std::move(src_plot.at(i)));
-    }
-    src_plot.clear();
+    // move the points of src_plot in front and append the old ones
+    TimeseriesBase<Value> old_points(dst_plot.plotName(), {});
+    old_points.clonePoints(std::move(dst_plot));
+    dst_plot.clonePoints(std::move(src_plot));
+    dst_plot.splicePoints(std::move(old_points));
     return;
   }
   // LAST CASE: merging
@@ -87,16 +97,7 @@ void MergeData(TimeseriesBase<Value>& src_plot, TimeseriesBase<Value>& dst_plot)
 
 void MergeData(PlotDataXY& src_plot, PlotDataXY& dst_plot)
 {
-  if (dst_plot.size() == 0)
-  {
-    std::swap(dst_plot, src_plot);
-    return;
-  }
-  for (const auto& p : src_plot)
-  {
-    dst_plot.pushBack(p);
-  }
-  src_plot.clear();
+  dst_plot.splicePoints(std::move(src_plot));
 }
 
 void MergeData(StringSeries& src_plot, StringSeries& dst_plot)
@@ -107,7 +108,7 @@ void MergeData(StringSeries& src_plot, StringSeries& dst_plot)
   }
   if (dst_plot.size() == 0)
   {
-    std::swap(dst_plot, src_plot);
+    dst_plot.clonePoints(std::move(src_plot));
     return;
   }
   for (size_t i = 0; i < src_plot.size(); i++)
@@ -119,76 +120,121 @@ void MergeData(StringSeries& src_plot, StringSeries& dst_plot)
   src_plot.clear();
 }
 
-MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination, bool remove_older)
+namespace
 {
-  MoveDataRet ret;
+// below this number of series to merge, the overhead of the thread pool is not worth it
+constexpr size_t PARALLEL_MERGE_MIN_SERIES = 8;
 
-  auto moveDataImpl = [&](auto& source_series, auto& destination_series) {
-    for (auto& [source_ID, source_plot] : source_series)
+// number of series moved by TakeStreamedData while holding the mutex of the streamer
+constexpr size_t STREAMED_DATA_SHARD_SIZE = 256;
+
+/**
+ * Find or create the destination of the series at position [index] of [source_series],
+ * copy its attributes and group and move its points.
+ *
+ * Moving the points into an empty series is O(1) and it is done right away.
+ * Otherwise the merge is added to [merge_jobs], if not null, to be executed later.
+ */
+template <typename SeriesMapT>
+void MoveSeries(SeriesMapT& source_series, size_t index, SeriesMapT& destination_series,
+                PlotDataMapRef& destination, bool remove_older, MoveDataRet& ret,
+                std::vector<std::function<void()>>* merge_jobs)
+{
+  auto source_it = source_series.begin() + index;
+  auto& [source_ID, source_plot] = *source_it;
+  const std::string& plot_name = source_plot.plotName();
+
+  // the SeriesId is the same in both maps: no need to hash the name
+  auto dest_plot_it = destination_series.find(source_series.id(source_it));
+  if (dest_plot_it == destination_series.end())
+  {
+    ret.added_curves.push_back(source_ID);
+
+    PlotGroup::Ptr group;
+    if (source_plot.group())
     {
-      const std::string& plot_name = source_plot.plotName();
+      destination.getOrCreateGroup(source_plot.group()->name());
+    }
+    dest_plot_it = destination_series
+                       .emplace(std::piecewise_construct, std::forward_as_tuple(source_ID),
+                                std::forward_as_tuple(plot_name, group))
+                       .first;
+    ret.curves_updated = true;
+  }
 
-      auto dest_plot_it = destination_series.find(source_ID);
-      if (dest_plot_it == destination_series.end())
+  auto& destination_plot = dest_plot_it->second;
+  PlotGroup::Ptr destination_group = destination_plot.group();
+
+  // copy plot attributes
+  for (const auto& [name, attr] : source_plot.attributes())
+  {
+    if (destination_plot.attribute(name) != attr)
+    {
+      destination_plot.setAttribute(name, attr);
+      ret.curves_updated = true;
+    }
+  }
+  // Copy the group name and attributes
+  if (source_plot.group())
+  {
+    if (!destination_group || destination_group->name() != source_plot.group()->name())
+    {
+      destination_group = destination.getOrCreateGroup(source_plot.group()->name());
+      destination_plot.changeGroup(destination_group);
+    }
+
+    for (const auto& [name, attr] : source_plot.group()->attributes())
+    {
+      if (destination_group->attribute(name) != attr)
       {
-        ret.added_curves.push_back(source_ID);
-
-        PlotGroup::Ptr group;
-        if (source_plot.group())
-        {
-          destination.getOrCreateGroup(source_plot.group()->name());
-        }
-        dest_plot_it = destination_series
-                           .emplace(std::piecewise_construct, std::forward_as_tuple(source_ID),
-                                    std::forward_as_tuple(plot_name, group))
-                           .first;
+        destination_group->setAttribute(name, attr);
         ret.curves_updated = true;
       }
+    }
+  }
 
-      auto& destination_plot = dest_plot_it->second;
-      PlotGroup::Ptr destination_group = destination_plot.group();
+  if (remove_older)
+  {
+    destination_plot.clear();
+  }
 
-      // copy plot attributes
-      for (const auto& [name, attr] : source_plot.attributes())
-      {
-        if (destination_plot.attribute(name) != attr)
-        {
-          destination_plot.setAttribute(name, attr);
-          ret.curves_updated = true;
-        }
-      }
-      // Copy the group name and attributes
-      if (source_plot.group())
-      {
-        if (!destination_group || destination_group->name() != source_plot.group()->name())
-        {
-          destination_group = destination.getOrCreateGroup(source_plot.group()->name());
-          destination_plot.changeGroup(destination_group);
-        }
-
-        for (const auto& [name, attr] : source_plot.group()->attributes())
-        {
-          if (destination_group->attribute(name) != attr)
-          {
-            destination_group->setAttribute(name, attr);
-            ret.curves_updated = true;
-          }
-        }
-      }
+  destination_plot.setValueType(source_plot.valueType());
 
-      if (remove_older)
-      {
-        destination_plot.clear();
-      }
+  using SeriesT = std::decay_t<decltype(source_plot)>;
+  if constexpr (std::is_same_v<PlotData, SeriesT> || std::is_same_v<StringSeries, SeriesT> ||
+                std::is_same_v<PlotDataAny, SeriesT>)
+  {
+    double max_range_x = source_plot.maximumRangeX();
+    destination_plot.setMaximumRangeX(max_range_x);
+  }
 
-      if constexpr (std::is_same_v<PlotData, decltype(source_plot)> ||
-                    std::is_same_v<StringSeries, decltype(source_plot)> ||
-                    std::is_same_v<PlotDataAny, decltype(source_plot)>)
-      {
-        double max_range_x = source_plot.maximumRangeX();
-        destination_plot.setMaximumRangeX(max_range_x);
-      }
-      MergeData(source_plot, destination_plot);
+  if (source_plot.size() > 0)
+  {
+    ret.data_pushed = true;
+  }
+
+  if (!merge_jobs || source_plot.size() == 0 || destination_plot.size() == 0)
+  {
+    MergeData(source_plot, destination_plot);
+    return;
+  }
+  // each job accesses only its own pair of series
+  SeriesT* src = &source_plot;
+  SeriesT* dst = &destination_plot;
+  merge_jobs->push_back([src, dst]() { MergeData(*src, *dst); });
+}
+}  // namespace
+
+MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination, bool remove_older)
+{
+  MoveDataRet ret;
+  std::vector<std::function<void()>> merge_jobs;
+
+  auto moveDataImpl = [&](auto& source_series, auto& destination_series) {
+    for (size_t i = 0; i < source_series.size(); i++)
+    {
+      MoveSeries(source_series, i, destination_series, destination, remove_older, ret,
+                 &merge_jobs);
     }
   };
 
@@ -198,7 +244,46 @@ MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination, bool r
   moveDataImpl(source.scatter_xy, destination.scatter_xy);
   moveDataImpl(source.user_defined, destination.user_defined);
 
+  if (merge_jobs.size() < PARALLEL_MERGE_MIN_SERIES)
+  {
+    for (auto& job : merge_jobs)
+    {
+      job();
+    }
+  }
+  else
+  {
+    QtConcurrent::blockingMap(merge_jobs, [](std::function<void()>& job) { job(); });
+  }
   return ret;
 }
 
+void TakeStreamedData(PlotDataMapRef& source, std::mutex& source_mutex, PlotDataMapRef& staging)
+{
+  MoveDataRet ret;
+
+  auto takeDataImpl = [&](auto& source_series, auto& staging_series) {
+    // Series are visited by index, because the producer may add new ones while the
+    // mutex is released. They will be moved at the next call.
+    for (size_t first = 0;; first += STREAMED_DATA_SHARD_SIZE)
+    {
+      std::lock_guard<std::mutex> lock(source_mutex);
+      const size_t last = std::min(first + STREAMED_DATA_SHARD_SIZE, source_series.size());
+      if (first >= last)
+      {
+        break;
+      }
+      for (size_t i = first; i < last; i++)
+      {
+        MoveSeries(source_series, i, staging_series, staging, false, ret, nullptr);
+      }
+    }
+  };
+
+  takeDataImpl(source.numeric, staging.numeric);
+  takeDataImpl(source.strings, staging.strings);
+  takeDataImpl(source.scatter_xy, staging.scatter_xy);
+  takeDataImpl(source.user_defined, staging.user_defined);
+}
+
 }  // namespace PJ
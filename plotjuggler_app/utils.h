@@ -8,6 +8,7 @@
 #define UTILS_H
 
 #include <QObject>
+#include <mutex>
 #include "PlotJuggler/plotdata.h"
 
 namespace PJ
@@ -63,7 +64,22 @@ struct MoveDataRet
   bool data_pushed = false;
 };
 
+/**
+ * @brief Move the points of [source] into [destination], creating the series that
+ * don't exist yet. The series are merged in parallel, using the global QThreadPool.
+ */
 MoveDataRet MoveData(PlotDataMapRef& source, PlotDataMapRef& destination, bool remove_older);
+
+/**
+ * @brief Move the new points of a streamer from [source], protected by [source_mutex],
+ * into [staging].
+ *
+ * The mutex is acquired for a shard of series at a time. When the series of [staging]
+ * are empty (i.e. it was already passed to MoveData), moving the points is a swap, so
+ * the producer thread is never blocked for longer than a shard of swaps.
+ */
+void TakeStreamedData(PlotDataMapRef& source, std::mutex& source_mutex,
+                      PlotDataMapRef& staging);
 }  // namespace PJ
 
 #endif  // UTILS_H
@@ -0,0 +1,327 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_CHUNK_COMPRESSION_H
+#define PJ_CHUNK_COMPRESSION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace PJ
+{
+/**
+ * @brief Lossless compression of the sealed chunks of a series, inspired by the
+ * "Gorilla" paper (Pelkonen et al., VLDB 2015):
+ *
+ * - X is encoded as delta-of-delta of the bit pattern of the doubles. With a regular
+ *   sampling rate it is almost always zero, i.e. 1 bit per sample.
+ * - Y is encoded as XOR with the previous value, storing only the meaningful bits.
+ *
+ * Compression is optional, because random access to a compressed chunk requires
+ * decompressing it first (see ChunkedColumns).
+ * There is a single instance shared by the application and all the plugins.
+ */
+class ChunkCompression
+{
+public:
+  static ChunkCompression* instance();
+
+  bool isEnabled() const
+  {
+    return _enabled;
+  }
+
+  /// Chunks already sealed are not affected; the option affects only new chunks.
+  void setEnabled(bool enabled)
+  {
+    _enabled = enabled;
+  }
+
+  /// Thread-safe. A new identifier of packed chunk, unique in the application and all
+  /// the plugins; it is the key of the unpacked copies cached by ChunkedColumns.
+  uint64_t newPackedChunkId()
+  {
+    return ++_last_packed_chunk_id;
+  }
+
+  static void Compress(const double* x, const double* y, size_t count,
+                       std::vector<uint64_t>& output);
+
+  static void Decompress(const std::vector<uint64_t>& input, size_t count, double* x,
+                         double* y);
+
+private:
+  std::atomic_bool _enabled{ false };
+  std::atomic<uint64_t> _last_packed_chunk_id{ 0 };
+};
+
+//------------------------------------------------------------
+
+namespace detail
+{
+inline unsigned CountLeadingZeros(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  return _BitScanReverse64(&index, value) ? 63 - index : 64;
+#else
+  return value == 0 ? 64 : __builtin_clzll(value);
+#endif
+}
+
+inline unsigned CountTrailingZeros(uint64_t value)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  return _BitScanForward64(&index, value) ? index : 64;
+#else
+  return value == 0 ? 64 : __builtin_ctzll(value);
+#endif
+}
+
+inline uint64_t ToBits(double value)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double FromBits(uint64_t bits)
+{
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+class BitWriter
+{
+public:
+  explicit BitWriter(std::vector<uint64_t>& buffer) : _buffer(buffer)
+  {
+  }
+
+  // write the [bits] least significant bits of value. bits must be in range [1, 64]
+  void write(uint64_t value, unsigned bits)
+  {
+    if (bits < 64)
+    {
+      value &= (uint64_t(1) << bits) - 1;
+    }
+    if (_free == 0)
+    {
+      _buffer.push_back(0);
+      _free = 64;
+    }
+    if (bits <= _free)
+    {
+      _buffer.back() |= value << (_free - bits);
+      _free -= bits;
+    }
+    else
+    {
+      const unsigned rest = bits - _free;
+      _buffer.back() |= value >> rest;
+      _buffer.push_back(value << (64 - rest));
+      _free = 64 - rest;
+    }
+  }
+
+private:
+  std::vector<uint64_t>& _buffer;
+  unsigned _free = 0;
+};
+
+class BitReader
+{
+public:
+  explicit BitReader(const std::vector<uint64_t>& buffer) : _data(buffer.data())
+  {
+  }
+
+  // read [bits] bits, in range [1, 64]
+  uint64_t read(unsigned bits)
+  {
+    const size_t word = _pos >> 6;
+    const unsigned offset = _pos & 63;
+    const unsigned available = 64 - offset;
+    uint64_t result;
+    if (bits <= available)
+    {
+      result = (_data[word] << offset) >> (64 - bits);
+    }
+    else
+    {
+      const unsigned rest = bits - available;
+      result = ((_data[word] << offset) >> offset) << rest;
+      result |= _data[word + 1] >> (64 - rest);
+    }
+    _pos += bits;
+    return result;
+  }
+
+private:
+  const uint64_t* _data;
+  size_t _pos = 0;
+};
+}  // namespace detail
+
+inline void ChunkCompression::Compress(const double* x, const double* y, size_t count,
+                                       std::vector<uint64_t>& output)
+{
+  using namespace detail;
+  output.clear();
+  if (count == 0)
+  {
+    return;
+  }
+  BitWriter writer(output);
+
+  uint64_t prev_x = ToBits(x[0]);
+  uint64_t prev_y = ToBits(y[0]);
+  writer.write(prev_x, 64);
+  writer.write(prev_y, 64);
+
+  uint64_t prev_delta = 0;
+  unsigned prev_leading = 65;  // no window yet
+  unsigned prev_trailing = 0;
+
+  for (size_t i = 1; i < count; i++)
+  {
+    // X: delta-of-delta, zig-zag encoded (wrapping arithmetic is lossless)
+    const uint64_t bits_x = ToBits(x[i]);
+    const uint64_t delta = bits_x - prev_x;
+    const int64_t dod = static_cast<int64_t>(delta - prev_delta);
+    const uint64_t zz = (static_cast<uint64_t>(dod) << 1) ^ static_cast<uint64_t>(dod >> 63);
+    if (zz == 0)
+    {
+      writer.write(0b0, 1);
+    }
+    else if (zz < (1 << 7))
+    {
+      writer.write(0b10, 2);
+      writer.write(zz, 7);
+    }
+    else if (zz < (1 << 9))
+    {
+      writer.write(0b110, 3);
+      writer.write(zz, 9);
+    }
+    else if (zz < (1 << 12))
+    {
+      writer.write(0b1110, 4);
+      writer.write(zz, 12);
+    }
+    else
+    {
+      writer.write(0b1111, 4);
+      writer.write(zz, 64);
+    }
+    prev_delta = delta;
+    prev_x = bits_x;
+
+    // Y: XOR with the previous value
+    const uint64_t bits_y = ToBits(y[i]);
+    const uint64_t xor_y = bits_y ^ prev_y;
+    prev_y = bits_y;
+    if (xor_y == 0)
+    {
+      writer.write(0b0, 1);
+      continue;
+    }
+    const unsigned leading = std::min(CountLeadingZeros(xor_y), 63u);
+    const unsigned trailing = CountTrailingZeros(xor_y);
+    if (prev_leading <= 64 && leading >= prev_leading && trailing >= prev_trailing)
+    {
+      // the meaningful bits fit in the previous window
+      writer.write(0b10, 2);
+      writer.write(xor_y >> prev_trailing, 64 - prev_leading - prev_trailing);
+    }
+    else
+    {
+      const unsigned length = 64 - leading - trailing;
+      writer.write(0b11, 2);
+      writer.write(leading, 6);
+      writer.write(length - 1, 6);
+      writer.write(xor_y >> trailing, length);
+      prev_leading = leading;
+      prev_trailing = trailing;
+    }
+  }
+  output.shrink_to_fit();
+}
+
+inline void ChunkCompression::Decompress(const std::vector<uint64_t>& input, size_t count,
+                                         double* x, double* y)
+{
+  using namespace detail;
+  if (count == 0)
+  {
+    return;
+  }
+  BitReader reader(input);
+
+  uint64_t prev_x = reader.read(64);
+  uint64_t prev_y = reader.read(64);
+  x[0] = FromBits(prev_x);
+  y[0] = FromBits(prev_y);
+
+  uint64_t prev_delta = 0;
+  unsigned prev_leading = 0;
+  unsigned prev_trailing = 0;
+
+  for (size_t i = 1; i < count; i++)
+  {
+    uint64_t zz = 0;
+    if (reader.read(1) != 0)
+    {
+      if (reader.read(1) == 0)
+      {
+        zz = reader.read(7);
+      }
+      else if (reader.read(1) == 0)
+      {
+        zz = reader.read(9);
+      }
+      else if (reader.read(1) == 0)
+      {
+        zz = reader.read(12);
+      }
+      else
+      {
+        zz = reader.read(64);
+      }
+    }
+    const uint64_t dod = (zz >> 1) ^ (~(zz & 1) + 1);
+    prev_delta += dod;
+    prev_x += prev_delta;
+    x[i] = FromBits(prev_x);
+
+    if (reader.read(1) != 0)
+    {
+      if (reader.read(1) != 0)
+      {
+        prev_leading = static_cast<unsigned>(reader.read(6));
+        const unsigned length = static_cast<unsigned>(reader.read(6)) + 1;
+        prev_trailing = 64 - prev_leading - length;
+      }
+      const unsigned length = 64 - prev_leading - prev_trailing;
+      prev_y ^= reader.read(length) << prev_trailing;
+    }
+    y[i] = FromBits(prev_y);
+  }
+}
+
+}  // namespace PJ
+
+#endif  // PJ_CHUNK_COMPRESSION_H
@@ -0,0 +1,1527 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_CHUNKED_COLUMNS_H
+#define PJ_CHUNKED_COLUMNS_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "chunk_compression.h"
+#include "disk_storage.h"
+#include "pj_serializer.hpp"
+
+namespace PJ
+{
+/**
+ * @brief Sealed chunks of X shared by multiple series.
+ *
+ * Series parsed from the same message (for instance, all the fields of a ROS topic)
+ * receive the same timestamps. When their chunks are sealed, those with identical X are
+ * stored only once; each series keeps only its own Y.
+ */
+class ColumnPool
+{
+public:
+  using Column = std::shared_ptr<const std::vector<double>>;
+
+  /// Returns a column equal to [values]: either an existing one, or a new one
+  /// that takes ownership of [values].
+  Column intern(std::vector<double>&& values)
+  {
+    if (values.empty())
+    {
+      return std::make_shared<const std::vector<double>>(std::move(values));
+    }
+    const uint64_t key = makeKey(values);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto& entry = _columns[key];
+    if (auto existing = entry.lock())
+    {
+      if (existing->size() == values.size() &&
+          std::memcmp(existing->data(), values.data(), values.size() * sizeof(double)) == 0)
+      {
+        return existing;
+      }
+    }
+    auto column = std::make_shared<const std::vector<double>>(std::move(values));
+    entry = column;
+
+    if (_columns.size() >= _next_purge)
+    {
+      for (auto it = _columns.begin(); it != _columns.end();)
+      {
+        it = it->second.expired() ? _columns.erase(it) : std::next(it);
+      }
+      _next_purge = 2 * _columns.size() + 64;
+    }
+    return column;
+  }
+
+private:
+  static uint64_t makeKey(const std::vector<double>& values)
+  {
+    uint64_t front, back;
+    std::memcpy(&front, &values.front(), sizeof(front));
+    std::memcpy(&back, &values.back(), sizeof(back));
+    return (front * 0x9E3779B97F4A7C15ull) ^ (back + values.size());
+  }
+
+  std::mutex _mutex;
+  std::unordered_map<uint64_t, std::weak_ptr<const std::vector<double>>> _columns;
+  size_t _next_purge = 64;
+};
+
+/**
+ * @brief Random access iterator over a container whose elements are returned by value
+ * (or by proxy) from operator[]. It stores only the container and the index.
+ */
+template <typename Container, typename ValueT>
+class IndexIterator
+{
+public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = ValueT;
+  using difference_type = std::ptrdiff_t;
+  using reference = decltype(std::declval<Container&>()[size_t(0)]);
+
+  // operator-> needs to return something that owns the temporary element
+  struct pointer
+  {
+    std::remove_const_t<reference> element;
+    const std::remove_const_t<reference>* operator->() const
+    {
+      return &element;
+    }
+  };
+
+  IndexIterator() = default;
+
+  IndexIterator(Container* container, size_t index) : _container(container), _index(index)
+  {
+  }
+
+  // an iterator can be converted to a const_iterator
+  template <typename Other,
+            typename = std::enable_if_t<std::is_convertible_v<Other*, Container*>>>
+  IndexIterator(const IndexIterator<Other, ValueT>& other)
+    : _container(other.container()), _index(other.index())
+  {
+  }
+
+  Container* container() const
+  {
+    return _container;
+  }
+
+  size_t index() const
+  {
+    return _index;
+  }
+
+  reference operator*() const
+  {
+    return (*_container)[_index];
+  }
+
+  pointer operator->() const
+  {
+    return { (*_container)[_index] };
+  }
+
+  reference operator[](difference_type n) const
+  {
+    return (*_container)[_index + n];
+  }
+
+  IndexIterator& operator++()
+  {
+    ++_index;
+    return *this;
+  }
+
+  IndexIterator operator++(int)
+  {
+    auto prev = *this;
+    ++_index;
+    return prev;
+  }
+
+  IndexIterator& operator--()
+  {
+    --_index;
+    return *this;
+  }
+
+  IndexIterator operator--(int)
+  {
+    auto prev = *this;
+    --_index;
+    return prev;
+  }
+
+  IndexIterator& operator+=(difference_type n)
+  {
+    _index += n;
+    return *this;
+  }
+
+  IndexIterator& operator-=(difference_type n)
+  {
+    _index -= n;
+    return *this;
+  }
+
+  IndexIterator operator+(difference_type n) const
+  {
+    return IndexIterator(_container, _index + n);
+  }
+
+  friend IndexIterator operator+(difference_type n, const IndexIterator& it)
+  {
+    return it + n;
+  }
+
+  IndexIterator operator-(difference_type n) const
+  {
+    return IndexIterator(_container, _index - n);
+  }
+
+  difference_type operator-(const IndexIterator& other) const
+  {
+    return difference_type(_index) - difference_type(other._index);
+  }
+
+  bool operator==(const IndexIterator& other) const
+  {
+    return _index == other._index;
+  }
+  bool operator!=(const IndexIterator& other) const
+  {
+    return _index != other._index;
+  }
+  bool operator<(const IndexIterator& other) const
+  {
+    return _index < other._index;
+  }
+  bool operator>(const IndexIterator& other) const
+  {
+    return _index > other._index;
+  }
+  bool operator<=(const IndexIterator& other) const
+  {
+    return _index <= other._index;
+  }
+  bool operator>=(const IndexIterator& other) const
+  {
+    return _index >= other._index;
+  }
+
+private:
+  Container* _container = nullptr;
+  size_t _index = 0;
+};
+
+/**
+ * @brief Columnar storage of the points of a series.
+ *
+ * X and Y are stored in two separate arrays, split in chunks of CHUNK_SIZE elements.
+ * Compared with a std::deque<Point>:
+ *
+ * - the overhead is a single pointer every CHUNK_SIZE samples;
+ * - scanning a single column (for instance to compute a range) touches only the
+ *   memory of that column and can be vectorized by the compiler (see forEachSpan);
+ * - pushBack and popFront are O(1), random access is O(1).
+ *
+ * When Value is arithmetic, the minimum and maximum of Y are also stored for every
+ * block of BLOCK_SIZE elements and for every chunk. They are updated incrementally
+ * and make rangeY(first, last) proportional to the number of chunks in the interval,
+ * instead of the number of samples.
+ * Additionally, two monotonic queues of chunks (the "sliding window minimum/maximum")
+ * make rangeY of an interval that ends with the last element independent of the number
+ * of chunks: this is the typical query of a streaming buffer, where pop_front(count)
+ * drops the expired elements, one entire chunk at a time.
+ *
+ * Sealed chunks can be moved to the DiskStorage, if enabled: the samples are then
+ * accessed through a memory map, while the summaries stay in memory.
+ *
+ * Alternatively, sealed chunks of doubles can be "packed" in memory:
+ *
+ * - compressed, if ChunkCompression is enabled;
+ * - narrowed, if the native type of the values is smaller than a double
+ *   (see setValueType). For instance a series of float32 uses 12 bytes per sample
+ *   instead of 16. Values that can not be represented exactly keep the chunk in doubles.
+ *
+ * Sealed chunks of doubles can also share X with the chunks of other series, through a
+ * ColumnPool passed to push_back.
+ *
+ * Packed chunks are unpacked on access into a small cache of HOT_CHUNKS chunks, owned
+ * by the calling thread: reading never modifies the container, and a const instance can
+ * be read concurrently by multiple threads. The pointers passed to forEachSpan are valid
+ * only inside the callback. The last chunk, where new samples are appended, is never
+ * packed.
+ *
+ * Since points are not stored physically, they are returned by value.
+ */
+template <typename TypeX, typename Value, typename PointT>
+class ChunkedColumns
+{
+public:
+  static constexpr size_t CHUNK_BITS = 12;
+  static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_BITS;
+  static constexpr size_t CHUNK_MASK = CHUNK_SIZE - 1;
+
+  static constexpr size_t BLOCK_BITS = 6;
+  static constexpr size_t BLOCK_SIZE = size_t(1) << BLOCK_BITS;
+  static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+
+  static constexpr bool HAS_SUMMARY = std::is_arithmetic_v<Value>;
+
+  struct MinMax
+  {
+    double min;
+    double max;
+  };
+
+  // Chunks can be moved to a DiskStorage only if they can be copied with memcpy
+  static constexpr bool CAN_SPILL =
+      std::is_trivially_copyable_v<TypeX> && std::is_trivially_copyable_v<Value> &&
+      CHUNK_SIZE * (sizeof(TypeX) + sizeof(Value)) <= DiskStorage::SLOT_SIZE;
+
+  static constexpr bool CAN_PACK = std::is_same_v<TypeX, double> && std::is_same_v<Value, double>;
+
+  // number of packed chunks that each thread can keep unpacked at the same time
+  static constexpr size_t HOT_CHUNKS = 4;
+
+  class Chunk
+  {
+  public:
+    // x and y point either to the buffers in memory or to a DiskStorage slot.
+    // If the chunk is packed, the packed columns are null.
+    TypeX* x = nullptr;
+    Value* y = nullptr;
+    size_t size = 0;
+
+    // min/max of y for each block of BLOCK_SIZE elements (only if HAS_SUMMARY)
+    std::vector<MinMax> blocks;
+    MinMax total = { 0, 0 };
+
+    // first and last x, available even if the chunk is packed
+    TypeX first_x = {};
+    TypeX last_x = {};
+
+    explicit Chunk(size_t capacity = 0)
+    {
+      _x_buffer.reserve(capacity);
+      _y_buffer.reserve(capacity);
+    }
+
+    Chunk(const Chunk& other)
+      : size(other.size)
+      , blocks(other.blocks)
+      , total(other.total)
+      , first_x(other.first_x)
+      , last_x(other.last_x)
+      , _packed_id(other._packed_id)
+    {
+      if (other.isCompressed())
+      {
+        _compressed = other._compressed;
+        return;
+      }
+      if (other.isShared())
+      {
+        _shared_x = other._shared_x;
+        x = const_cast<TypeX*>(_shared_x->data());
+      }
+      else
+      {
+        _x_buffer.assign(other.x, other.x + other.size);
+        x = _x_buffer.data();
+      }
+      if (other.isNarrow())
+      {
+        _narrow_y = other._narrow_y;
+        _narrow_type = other._narrow_type;
+      }
+      else
+      {
+        _y_buffer.assign(other.y, other.y + other.size);
+        y = _y_buffer.data();
+      }
+    }
+
+    Chunk& operator=(const Chunk& other) = delete;
+
+    void push(const TypeX& vx, const Value& vy)
+    {
+      if (size == 0)
+      {
+        first_x = vx;
+      }
+      last_x = vx;
+      _x_buffer.push_back(vx);
+      _y_buffer.push_back(vy);
+      x = _x_buffer.data();
+      y = _y_buffer.data();
+      size++;
+    }
+
+    void append(const TypeX* vx, const Value* vy, size_t count)
+    {
+      if (count == 0)
+      {
+        return;
+      }
+      if (size == 0)
+      {
+        first_x = vx[0];
+      }
+      last_x = vx[count - 1];
+      _x_buffer.insert(_x_buffer.end(), vx, vx + count);
+      _y_buffer.insert(_y_buffer.end(), vy, vy + count);
+      x = _x_buffer.data();
+      y = _y_buffer.data();
+      size += count;
+    }
+
+    // Must be called after x is modified.
+    void updateBoundsX()
+    {
+      first_x = x[0];
+      last_x = x[size - 1];
+    }
+
+    bool isSpilled() const
+    {
+      return _slot.valid();
+    }
+
+    // Move the samples to the DiskStorage and release the memory of the buffers.
+    void spill()
+    {
+      if constexpr (CAN_SPILL)
+      {
+        auto slot = DiskStorage::instance()->allocate();
+        if (!slot.valid())
+        {
+          return;
+        }
+        auto slot_x = reinterpret_cast<TypeX*>(slot.data());
+        auto slot_y = reinterpret_cast<Value*>(slot.data() + CHUNK_SIZE * sizeof(TypeX));
+        std::memcpy(slot_x, x, size * sizeof(TypeX));
+        std::memcpy(slot_y, y, size * sizeof(Value));
+        _slot = std::move(slot);
+        x = slot_x;
+        y = slot_y;
+        std::vector<TypeX>().swap(_x_buffer);
+        std::vector<Value>().swap(_y_buffer);
+      }
+    }
+
+    bool isCompressed() const
+    {
+      return !_compressed.empty();
+    }
+
+    bool isNarrow() const
+    {
+      return !_narrow_y.empty();
+    }
+
+    bool isPacked() const
+    {
+      return isCompressed() || isNarrow();
+    }
+
+    bool isShared() const
+    {
+      return _shared_x != nullptr;
+    }
+
+    // Identifies the packed samples: copies of the chunk, that have the same samples,
+    // have the same id.
+    uint64_t packedId() const
+    {
+      return _packed_id;
+    }
+
+    // Replace x with an identical column from the pool, if any.
+    void share(ColumnPool& pool)
+    {
+      if constexpr (CAN_PACK)
+      {
+        _shared_x = pool.intern(std::move(_x_buffer));
+        _x_buffer = {};
+        x = const_cast<TypeX*>(_shared_x->data());
+      }
+    }
+
+    // Compress the samples and release the memory of the buffers.
+    void compress()
+    {
+      if constexpr (CAN_PACK)
+      {
+        ChunkCompression::Compress(x, y, size, _compressed);
+        _packed_id = ChunkCompression::instance()->newPackedChunkId();
+        x = nullptr;
+        y = nullptr;
+        std::vector<TypeX>().swap(_x_buffer);
+        std::vector<Value>().swap(_y_buffer);
+      }
+    }
+
+    // Store y using the given type, if all the values can be represented exactly.
+    void narrow(BuiltinType type)
+    {
+      if constexpr (CAN_PACK)
+      {
+        bool done = false;
+        VisitNarrowType(type, [&](auto tag) {
+          done = NarrowValues<decltype(tag)>(y, size, _narrow_y);
+        });
+        if (!done)
+        {
+          std::vector<uint8_t>().swap(_narrow_y);
+          return;
+        }
+        _narrow_type = type;
+        _packed_id = ChunkCompression::instance()->newPackedChunkId();
+        y = nullptr;
+        std::vector<Value>().swap(_y_buffer);
+      }
+    }
+
+    // Unpack the packed columns into the given buffers, with capacity CHUNK_SIZE.
+    void load(TypeX* out_x, Value* out_y) const
+    {
+      if constexpr (CAN_PACK)
+      {
+        if (isCompressed())
+        {
+          ChunkCompression::Decompress(_compressed, size, out_x, out_y);
+        }
+        else
+        {
+          VisitNarrowType(_narrow_type, [&](auto tag) {
+            WidenValues<decltype(tag)>(_narrow_y, size, out_y);
+          });
+        }
+      }
+    }
+
+    // Convert the chunk to buffers that it owns and can modify, permanently.
+    void unpack()
+    {
+      if (isShared())
+      {
+        _x_buffer.assign(x, x + size);
+        _shared_x.reset();
+        x = _x_buffer.data();
+      }
+      if (isPacked())
+      {
+        if (isCompressed())
+        {
+          _x_buffer.resize(size);
+        }
+        _y_buffer.resize(size);
+        load(_x_buffer.data(), _y_buffer.data());
+        std::vector<uint64_t>().swap(_compressed);
+        std::vector<uint8_t>().swap(_narrow_y);
+        _packed_id = 0;
+        x = _x_buffer.data();
+        y = _y_buffer.data();
+      }
+    }
+
+  private:
+    std::vector<TypeX> _x_buffer;
+    std::vector<Value> _y_buffer;
+    DiskStorage::Slot _slot;
+    std::vector<uint64_t> _compressed;
+    std::vector<uint8_t> _narrow_y;
+    BuiltinType _narrow_type = BuiltinType::FLOAT64;
+    ColumnPool::Column _shared_x;
+    uint64_t _packed_id = 0;
+  };
+
+  using ConstIterator = IndexIterator<const ChunkedColumns, PointT>;
+
+  ChunkedColumns() = default;
+
+  ChunkedColumns(const ChunkedColumns& other)
+  {
+    *this = other;
+  }
+
+  ChunkedColumns(ChunkedColumns&& other)
+  {
+    *this = std::move(other);
+  }
+
+  ChunkedColumns& operator=(const ChunkedColumns& other)
+  {
+    if (this != &other)
+    {
+      _chunks.clear();
+      for (const auto& chunk : other._chunks)
+      {
+        _chunks.push_back(std::make_unique<Chunk>(*chunk));
+      }
+      _front = other._front;
+      _size = other._size;
+      _value_type = other._value_type;
+      _popped_chunks = other._popped_chunks;
+      _window_min = other._window_min;
+      _window_max = other._window_max;
+      _window_stale = other._window_stale;
+    }
+    return *this;
+  }
+
+  ChunkedColumns& operator=(ChunkedColumns&& other)
+  {
+    if (this != &other)
+    {
+      _chunks = std::move(other._chunks);
+      _front = other._front;
+      _size = other._size;
+      _value_type = other._value_type;
+      _popped_chunks = other._popped_chunks;
+      _window_min = std::move(other._window_min);
+      _window_max = std::move(other._window_max);
+      _window_stale = other._window_stale;
+      other.clear();
+    }
+    return *this;
+  }
+
+  size_t size() const
+  {
+    return _size;
+  }
+
+  bool empty() const
+  {
+    return _size == 0;
+  }
+
+  /// Native type of the values. It is used to narrow the sealed chunks of doubles.
+  BuiltinType valueType() const
+  {
+    return _value_type;
+  }
+
+  void setValueType(BuiltinType type)
+  {
+    _value_type = type;
+  }
+
+  TypeX xAt(size_t index) const
+  {
+    const size_t pos = _front + index;
+    // X of a narrowed chunk is not packed: Y is unpacked only if it is needed
+    const Chunk& chunk = *_chunks[pos >> CHUNK_BITS];
+    const size_t offset = pos & CHUNK_MASK;
+    if (chunk.x)
+    {
+      return chunk.x[offset];
+    }
+    if (offset == 0)
+    {
+      return chunk.first_x;
+    }
+    if (offset + 1 == chunk.size)
+    {
+      return chunk.last_x;
+    }
+    return chunkAt(pos >> CHUNK_BITS).x[offset];
+  }
+
+  Value yAt(size_t index) const
+  {
+    const size_t pos = _front + index;
+    return chunkAt(pos >> CHUNK_BITS).y[pos & CHUNK_MASK];
+  }
+
+  PointT operator[](size_t index) const
+  {
+    const size_t pos = _front + index;
+    const ChunkView chunk = chunkAt(pos >> CHUNK_BITS);
+    return PointT(chunk.x[pos & CHUNK_MASK], chunk.y[pos & CHUNK_MASK]);
+  }
+
+  PointT front() const
+  {
+    return (*this)[0];
+  }
+
+  PointT back() const
+  {
+    return (*this)[_size - 1];
+  }
+
+  ConstIterator begin() const
+  {
+    return ConstIterator(this, 0);
+  }
+
+  ConstIterator end() const
+  {
+    return ConstIterator(this, _size);
+  }
+
+  void set(size_t index, const PointT& p)
+  {
+    const size_t pos = _front + index;
+    Chunk& chunk = mutableChunkAt(pos >> CHUNK_BITS);
+    chunk.x[pos & CHUNK_MASK] = p.x;
+    chunk.y[pos & CHUNK_MASK] = p.y;
+    chunk.updateBoundsX();
+    if constexpr (HAS_SUMMARY)
+    {
+      const MinMax old_total = chunk.total;
+      updateBlock(chunk, (pos & CHUNK_MASK) >> BLOCK_BITS);
+      updateTotal(chunk);
+      // the queues are rebuilt once, by the next append (see updateWindow)
+      if (chunk.total.min != old_total.min || chunk.total.max != old_total.max)
+      {
+        _window_stale = true;
+      }
+    }
+  }
+
+  /// If [pool] is not null, X of the sealed chunks may be shared with other series.
+  void push_back(const PointT& p, ColumnPool* pool = nullptr)
+  {
+    Chunk& chunk = tailChunk(pool, 0);
+    if constexpr (HAS_SUMMARY)
+    {
+      const size_t offset = chunk.size;
+      const double y = p.y;
+      if ((offset & BLOCK_MASK) == 0)
+      {
+        chunk.blocks.push_back({ y, y });
+      }
+      else
+      {
+        expand(chunk.blocks.back(), y);
+      }
+      if (offset == 0)
+      {
+        chunk.total = { y, y };
+        updateWindow();
+      }
+      else if (y < chunk.total.min || y > chunk.total.max)
+      {
+        expand(chunk.total, y);
+        updateWindow();
+      }
+    }
+    chunk.push(p.x, p.y);
+    _size++;
+  }
+
+  /// Same as calling push_back for each element, but the elements are copied in bulk
+  /// and the summaries are updated once per block.
+  void append(const TypeX* x, const Value* y, size_t count, ColumnPool* pool = nullptr)
+  {
+    while (count > 0)
+    {
+      Chunk& chunk = tailChunk(pool, count);
+      const size_t offset = chunk.size;
+      const size_t n = std::min(count, CHUNK_SIZE - offset);
+      chunk.append(x, y, n);
+      if constexpr (HAS_SUMMARY)
+      {
+        for (size_t pos = offset; pos < chunk.size;)
+        {
+          const size_t block_end = std::min((pos | BLOCK_MASK) + 1, chunk.size);
+          MinMax range = { double(chunk.y[pos]), double(chunk.y[pos]) };
+          for (size_t i = pos + 1; i < block_end; i++)
+          {
+            expand(range, chunk.y[i]);
+          }
+          if ((pos & BLOCK_MASK) == 0)
+          {
+            chunk.blocks.push_back(range);
+          }
+          else
+          {
+            merge(chunk.blocks.back(), range);
+          }
+          pos = block_end;
+        }
+        updateTotal(chunk);
+        updateWindow();
+      }
+      x += n;
+      y += n;
+      count -= n;
+      _size += n;
+    }
+  }
+
+  /**
+   * @brief Append all the elements of [other], that becomes empty.
+   *
+   * If the elements of [other] are aligned to the chunks of this container (for
+   * instance, when the last chunk of this is full and [other] starts at the beginning
+   * of its first chunk), the sealed chunks are moved in O(1) each, together with their
+   * summaries. Otherwise, or if [other] has a single chunk, the elements are copied
+   * in bulk.
+   */
+  void splice(ChunkedColumns&& other, ColumnPool* pool = nullptr)
+  {
+    if (other.empty())
+    {
+      return;
+    }
+    const size_t offset = (_front + _size) & CHUNK_MASK;
+    if (other._front != offset || other._chunks.size() == 1)
+    {
+      other.forEachSpan(0, other._size, [&](const TypeX* x, const Value* y, size_t count) {
+        append(x, y, count, pool);
+      });
+      other.clear();
+      return;
+    }
+    if (offset != 0)
+    {
+      // fill the last chunk with the rest of the first chunk of other
+      const ChunkView first = other.chunkAt(0);
+      append(first.x + offset, first.y + offset, CHUNK_SIZE - offset, pool);
+      other._chunks.pop_front();
+      other._size -= CHUNK_SIZE - offset;
+    }
+    if (!_chunks.empty())
+    {
+      seal(*_chunks.back(), pool);
+    }
+    for (auto& chunk : other._chunks)
+    {
+      _chunks.push_back(std::move(chunk));
+      if constexpr (HAS_SUMMARY)
+      {
+        updateWindow();
+      }
+    }
+    _size += other._size;
+    other.clear();
+  }
+
+  void pop_front()
+  {
+    if constexpr (!std::is_trivially_destructible_v<Value>)
+    {
+      // release the resources owned by the element right away
+      _chunks.front()->y[_front] = Value();
+    }
+    _size--;
+    _front++;
+    if (_size == 0)
+    {
+      clear();
+    }
+    else if (_front == CHUNK_SIZE)
+    {
+      popFrontChunk();
+      _front = 0;
+    }
+  }
+
+  /// Remove the first [count] elements. Entire chunks are released at once,
+  /// therefore the complexity is O(count / CHUNK_SIZE).
+  void pop_front(size_t count)
+  {
+    if (count >= _size)
+    {
+      clear();
+      return;
+    }
+    if constexpr (!std::is_trivially_destructible_v<Value>)
+    {
+      for (size_t i = 0; i < count; i++)
+      {
+        pop_front();
+      }
+      return;
+    }
+    _size -= count;
+    _front += count;
+    for (size_t n = _front >> CHUNK_BITS; n > 0; n--)
+    {
+      popFrontChunk();
+    }
+    _front &= CHUNK_MASK;
+  }
+
+  /// Insert a point before the one at position [index]. Complexity O(size - index)
+  void insert(size_t index, const PointT& p)
+  {
+    if (index >= _size)
+    {
+      push_back(p);
+      return;
+    }
+    push_back(back());
+    for (size_t c = (_front + index) >> CHUNK_BITS; c < _chunks.size(); c++)
+    {
+      mutableChunkAt(c);
+    }
+    for (size_t i = _size - 2; i > index; i--)
+    {
+      const size_t dst = _front + i;
+      const size_t src = dst - 1;
+      Chunk& dst_chunk = *_chunks[dst >> CHUNK_BITS];
+      const Chunk& src_chunk = *_chunks[src >> CHUNK_BITS];
+      dst_chunk.x[dst & CHUNK_MASK] = src_chunk.x[src & CHUNK_MASK];
+      dst_chunk.y[dst & CHUNK_MASK] = src_chunk.y[src & CHUNK_MASK];
+    }
+    const size_t pos = _front + index;
+    _chunks[pos >> CHUNK_BITS]->x[pos & CHUNK_MASK] = p.x;
+    _chunks[pos >> CHUNK_BITS]->y[pos & CHUNK_MASK] = p.y;
+    for (size_t c = pos >> CHUNK_BITS; c < _chunks.size(); c++)
+    {
+      _chunks[c]->updateBoundsX();
+    }
+
+    if constexpr (HAS_SUMMARY)
+    {
+      for (size_t c = pos >> CHUNK_BITS; c < _chunks.size(); c++)
+      {
+        Chunk& chunk = *_chunks[c];
+        for (size_t b = 0; b < chunk.blocks.size(); b++)
+        {
+          updateBlock(chunk, b);
+        }
+        updateTotal(chunk);
+      }
+      rebuildWindow();
+    }
+  }
+
+  void clear()
+  {
+    _chunks.clear();
+    _front = 0;
+    _size = 0;
+    _popped_chunks = 0;
+    _window_min.clear();
+    _window_max.clear();
+    _window_stale = false;
+  }
+
+  /**
+   * @brief Index of the first element with x not less than [x] (std::lower_bound).
+   *
+   * The search starts from [hint] and expands exponentially, before switching to a
+   * binary search: it is O(1) when the hint is close to the result and O(log n) in the
+   * worst case.
+   */
+  size_t lowerBoundX(const TypeX& x, size_t hint) const
+  {
+    return boundX<false>(x, hint);
+  }
+
+  /// Same as lowerBoundX(x, hint). The hint is estimated by linear interpolation between
+  /// the first and the last element, that is exact when the sampling rate is uniform.
+  size_t lowerBoundX(const TypeX& x) const
+  {
+    return boundX<false>(x, interpolateX(x));
+  }
+
+  /// Index of the first element with x greater than [x] (std::upper_bound)
+  size_t upperBoundX(const TypeX& x, size_t hint) const
+  {
+    return boundX<true>(x, hint);
+  }
+
+  size_t upperBoundX(const TypeX& x) const
+  {
+    return boundX<true>(x, interpolateX(x));
+  }
+
+  /**
+   * @brief Visit the elements in the interval [first, last) as a sequence of contiguous
+   * arrays. The signature of the callback is:
+   *
+   *    void(const TypeX* x, const Value* y, size_t count)
+   */
+  template <typename Callback>
+  void forEachSpan(size_t first, size_t last, Callback&& callback) const
+  {
+    size_t pos = _front + first;
+    const size_t end_pos = _front + std::min(last, _size);
+    while (pos < end_pos)
+    {
+      const ChunkView chunk = chunkAt(pos >> CHUNK_BITS);
+      const size_t offset = pos & CHUNK_MASK;
+      const size_t count = std::min(CHUNK_SIZE - offset, end_pos - pos);
+      callback(chunk.x + offset, chunk.y + offset, count);
+      pos += count;
+    }
+  }
+
+  /**
+   * @brief Minimum and maximum of Y in the interval [first, last).
+   * Available only when Value is arithmetic and the interval is not empty.
+   *
+   * Complete chunks and blocks are resolved using their summary, therefore the
+   * complexity is O((last - first) / CHUNK_SIZE + CHUNK_SIZE / BLOCK_SIZE + BLOCK_SIZE).
+   * When [last] is size(), the chunks after the first one are resolved by the monotonic
+   * queues in O(log(size / CHUNK_SIZE)); after set() changed the range of a chunk, the
+   * queues are rebuilt only by the next append, and until then every chunk is visited.
+   */
+  std::optional<MinMax> rangeY(size_t first, size_t last) const
+  {
+    if constexpr (HAS_SUMMARY)
+    {
+      last = std::min(last, _size);
+      if (first >= last)
+      {
+        return std::nullopt;
+      }
+      MinMax result = { double(yAt(first)), double(yAt(first)) };
+
+      size_t pos = _front + first;
+      const size_t end_pos = _front + last;
+      while (pos < end_pos)
+      {
+        const Chunk& chunk = *_chunks[pos >> CHUNK_BITS];
+        const size_t chunk_start = pos & ~CHUNK_MASK;
+        const size_t chunk_end = chunk_start + chunk.size;
+
+        if (pos == chunk_start && end_pos == _front + _size && !_window_stale)
+        {
+          merge(result, windowRange(pos >> CHUNK_BITS));
+          break;
+        }
+        if (pos == chunk_start && end_pos >= chunk_end)
+        {
+          merge(result, chunk.total);
+          pos = chunk_end;
+          continue;
+        }
+        const size_t stop = std::min(end_pos, chunk_end);
+        const Value* chunk_y = nullptr;
+        while (pos < stop)
+        {
+          const size_t block_start = pos & ~BLOCK_MASK;
+          const size_t block_end = std::min(block_start + BLOCK_SIZE, chunk_end);
+          if (pos == block_start && stop >= block_end)
+          {
+            merge(result, chunk.blocks[(block_start - chunk_start) >> BLOCK_BITS]);
+            pos = block_end;
+          }
+          else
+          {
+            const size_t partial_end = std::min(stop, block_end);
+            if (!chunk_y)
+            {
+              chunk_y = chunkAt(pos >> CHUNK_BITS).y;
+            }
+            for (; pos < partial_end; pos++)
+            {
+              expand(result, chunk_y[pos - chunk_start]);
+            }
+          }
+        }
+      }
+      return result;
+    }
+    return std::nullopt;
+  }
+
+private:
+  // true if the element at [index] comes before the lower (or upper) bound of x
+  template <bool UPPER>
+  bool beforeBound(size_t index, const TypeX& x) const
+  {
+    if constexpr (UPPER)
+    {
+      return !(x < xAt(index));
+    }
+    return xAt(index) < x;
+  }
+
+  // true if all the elements of the chunk come before the lower (or upper) bound of x
+  template <bool UPPER>
+  bool chunkBeforeBound(size_t chunk, const TypeX& x) const
+  {
+    const TypeX& last_x = _chunks[chunk]->last_x;
+    if constexpr (UPPER)
+    {
+      return !(x < last_x);
+    }
+    return last_x < x;
+  }
+
+  // Index in _chunks of the first chunk not entirely before the bound, or _chunks.size().
+  // Only the first and last x of the chunks are used: no chunk is unpacked.
+  template <bool UPPER>
+  size_t boundChunk(const TypeX& x, size_t hint_chunk) const
+  {
+    if (!chunkBeforeBound<UPPER>(hint_chunk, x) &&
+        (hint_chunk == 0 || chunkBeforeBound<UPPER>(hint_chunk - 1, x)))
+    {
+      return hint_chunk;
+    }
+    size_t first = 0;
+    size_t count = _chunks.size();
+    while (count > 0)
+    {
+      const size_t half = count / 2;
+      if (chunkBeforeBound<UPPER>(first + half, x))
+      {
+        first += half + 1;
+        count -= half + 1;
+      }
+      else
+      {
+        count = half;
+      }
+    }
+    return first;
+  }
+
+  template <bool UPPER>
+  size_t boundX(const TypeX& x, size_t hint) const
+  {
+    if (_size == 0)
+    {
+      return 0;
+    }
+    hint = std::min(hint, _size - 1);
+
+    // the result is in the first chunk whose last element is not before the bound;
+    // then the search continues inside that chunk, that is the only one unpacked
+    const size_t chunk = boundChunk<UPPER>(x, (_front + hint) >> CHUNK_BITS);
+    if (chunk == _chunks.size())
+    {
+      return _size;
+    }
+    const size_t range_first = (chunk == 0) ? 0 : (chunk << CHUNK_BITS) - _front;
+    const size_t range_last = std::min(((chunk + 1) << CHUNK_BITS) - _front, _size);
+    hint = std::clamp(hint, range_first, range_last - 1);
+
+    // find an interval [first, last] that contains the result, with increasing steps
+    size_t first = range_first;
+    size_t last = range_last;
+    size_t step = 1;
+    if (beforeBound<UPPER>(hint, x))
+    {
+      first = hint + 1;
+      while (hint + step < range_last)
+      {
+        if (!beforeBound<UPPER>(hint + step, x))
+        {
+          last = hint + step;
+          break;
+        }
+        first = hint + step + 1;
+        step *= 2;
+      }
+    }
+    else
+    {
+      last = hint;
+      while (step <= hint - range_first)
+      {
+        if (beforeBound<UPPER>(hint - step, x))
+        {
+          first = hint - step + 1;
+          break;
+        }
+        last = hint - step;
+        step *= 2;
+      }
+    }
+    // binary search
+    size_t count = last - first;
+    while (count > 0)
+    {
+      const size_t half = count / 2;
+      if (beforeBound<UPPER>(first + half, x))
+      {
+        first += half + 1;
+        count -= half + 1;
+      }
+      else
+      {
+        count = half;
+      }
+    }
+    return first;
+  }
+
+  size_t interpolateX(const TypeX& x) const
+  {
+    if constexpr (std::is_arithmetic_v<TypeX>)
+    {
+      if (_size < 2)
+      {
+        return 0;
+      }
+      // an estimate is enough: the first x of the chunk doesn't need to unpack it
+      const double front = _chunks.front()->first_x;
+      const double back = _chunks.back()->last_x;
+      if (!(x > front))
+      {
+        return 0;
+      }
+      if (!(x < back))
+      {
+        return _size - 1;
+      }
+      const double ratio = (double(x) - front) / (back - front);
+      return size_t(ratio * double(_size - 1));
+    }
+    return _size / 2;
+  }
+
+  // Columns of a chunk, unpacked if needed
+  struct ChunkView
+  {
+    const TypeX* x;
+    const Value* y;
+  };
+
+  // Unpacked copy of a packed chunk.
+  struct HotChunk
+  {
+    uint64_t packed_id = 0;
+    std::vector<TypeX> x;
+    std::vector<Value> y;
+  };
+
+  struct HotChunkCache
+  {
+    std::array<HotChunk, HOT_CHUNKS> chunks;
+    size_t next = 0;
+  };
+
+  // The cache is per thread, therefore reading needs no synchronization.
+  // Entries of chunks that were unpacked or destroyed are never found again.
+  static HotChunkCache& hotChunkCache()
+  {
+    thread_local HotChunkCache cache;
+    return cache;
+  }
+
+  // The pointers are valid until the same thread unpacks HOT_CHUNKS other chunks.
+  ChunkView chunkAt(size_t index) const
+  {
+    const Chunk& chunk = *_chunks[index];
+    if constexpr (CAN_PACK)
+    {
+      if (chunk.isPacked())
+      {
+        HotChunkCache& cache = hotChunkCache();
+        for (const HotChunk& hot : cache.chunks)
+        {
+          if (hot.packed_id == chunk.packedId())
+          {
+            return { chunk.x ? chunk.x : hot.x.data(), hot.y.data() };
+          }
+        }
+        HotChunk& hot = cache.chunks[cache.next];
+        cache.next = (cache.next + 1) % HOT_CHUNKS;
+        if (chunk.isCompressed())
+        {
+          hot.x.resize(CHUNK_SIZE);
+        }
+        hot.y.resize(CHUNK_SIZE);
+        chunk.load(hot.x.data(), hot.y.data());
+        hot.packed_id = chunk.packedId();
+        return { chunk.x ? chunk.x : hot.x.data(), hot.y.data() };
+      }
+    }
+    return { chunk.x, chunk.y };
+  }
+
+  // Chunk where new elements are appended. If the last one is full, it is sealed and
+  // a new one is created. [expected] is the number of elements about to be appended.
+  Chunk& tailChunk(ColumnPool* pool, size_t expected)
+  {
+    if (_chunks.empty() || _chunks.back()->size == CHUNK_SIZE)
+    {
+      if (!_chunks.empty())
+      {
+        seal(*_chunks.back(), pool);
+      }
+      // the first chunk grows geometrically, to avoid wasting memory in short series
+      const size_t capacity = _chunks.empty() ? std::min(expected, CHUNK_SIZE) : CHUNK_SIZE;
+      _chunks.push_back(std::make_unique<Chunk>(capacity));
+    }
+    return *_chunks.back();
+  }
+
+  // Samples can not be modified in a packed or shared chunk: the chunk is unpacked.
+  Chunk& mutableChunkAt(size_t index)
+  {
+    Chunk& chunk = *_chunks[index];
+    if (chunk.isPacked() || chunk.isShared())
+    {
+      chunk.unpack();
+    }
+    return chunk;
+  }
+
+  void seal(Chunk& chunk, ColumnPool* pool)
+  {
+    if constexpr (CAN_PACK)
+    {
+      if (ChunkCompression::instance()->isEnabled())
+      {
+        chunk.compress();
+        return;
+      }
+    }
+    if constexpr (CAN_SPILL)
+    {
+      if (DiskStorage::instance()->isEnabled())
+      {
+        chunk.spill();
+        return;
+      }
+    }
+    if constexpr (CAN_PACK)
+    {
+      if (pool)
+      {
+        chunk.share(*pool);
+      }
+      if (_value_type != BuiltinType::FLOAT64)
+      {
+        chunk.narrow(_value_type);
+      }
+    }
+  }
+
+  // Call func(T()), where T is the C++ type of [type], if it is narrower than a double.
+  template <typename Function>
+  static bool VisitNarrowType(BuiltinType type, Function&& func)
+  {
+    switch (type)
+    {
+      case BuiltinType::BOOL:
+      case BuiltinType::UINT8:
+        func(uint8_t());
+        return true;
+      case BuiltinType::UINT16:
+        func(uint16_t());
+        return true;
+      case BuiltinType::UINT32:
+        func(uint32_t());
+        return true;
+      case BuiltinType::INT8:
+        func(int8_t());
+        return true;
+      case BuiltinType::INT16:
+        func(int16_t());
+        return true;
+      case BuiltinType::INT32:
+        func(int32_t());
+        return true;
+      case BuiltinType::FLOAT32:
+        func(float());
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // Returns false if any value can not be converted to T and back without loss.
+  template <typename T>
+  static bool NarrowValues(const double* values, size_t count, std::vector<uint8_t>& output)
+  {
+    output.resize(count * sizeof(T));
+    T* dst = reinterpret_cast<T*>(output.data());
+    for (size_t i = 0; i < count; i++)
+    {
+      const double value = values[i];
+      if constexpr (std::is_floating_point_v<T>)
+      {
+        if (std::isnan(value))
+        {
+          dst[i] = std::numeric_limits<T>::quiet_NaN();
+          continue;
+        }
+        if (std::isfinite(value) && std::abs(value) > std::numeric_limits<T>::max())
+        {
+          return false;
+        }
+      }
+      else if (!(value >= std::numeric_limits<T>::lowest() &&
+                 value <= std::numeric_limits<T>::max()))
+      {
+        return false;
+      }
+      dst[i] = static_cast<T>(value);
+      const double restored = static_cast<double>(dst[i]);
+      if (std::memcmp(&restored, &value, sizeof(double)) != 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template <typename T>
+  static void WidenValues(const std::vector<uint8_t>& input, size_t count, double* values)
+  {
+    const T* src = reinterpret_cast<const T*>(input.data());
+    for (size_t i = 0; i < count; i++)
+    {
+      values[i] = static_cast<double>(src[i]);
+    }
+  }
+
+  static void expand(MinMax& range, double value)
+  {
+    range.min = std::min(range.min, value);
+    range.max = std::max(range.max, value);
+  }
+
+  static void merge(MinMax& range, const MinMax& other)
+  {
+    range.min = std::min(range.min, other.min);
+    range.max = std::max(range.max, other.max);
+  }
+
+  static void updateBlock(Chunk& chunk, size_t block)
+  {
+    const size_t first = block << BLOCK_BITS;
+    const size_t last = std::min(first + BLOCK_SIZE, chunk.size);
+    MinMax& range = chunk.blocks[block];
+    range = { double(chunk.y[first]), double(chunk.y[first]) };
+    for (size_t i = first + 1; i < last; i++)
+    {
+      expand(range, chunk.y[i]);
+    }
+  }
+
+  static void updateTotal(Chunk& chunk)
+  {
+    chunk.total = chunk.blocks.front();
+    for (const auto& block : chunk.blocks)
+    {
+      merge(chunk.total, block);
+    }
+  }
+
+  void popFrontChunk()
+  {
+    _chunks.pop_front();
+    if (_window_stale)
+    {
+      _popped_chunks++;
+      return;
+    }
+    if (!_window_min.empty() && _window_min.front() == _popped_chunks)
+    {
+      _window_min.pop_front();
+    }
+    if (!_window_max.empty() && _window_max.front() == _popped_chunks)
+    {
+      _window_max.pop_front();
+    }
+    _popped_chunks++;
+  }
+
+  const MinMax& chunkTotal(size_t chunk_id) const
+  {
+    return _chunks[chunk_id - _popped_chunks]->total;
+  }
+
+  // Must be called when the total of the last chunk changes.
+  // The queues contain the ids of the chunks that are the minimum (maximum) of all the
+  // following ones; entries of the last chunk are replaced.
+  void updateWindow()
+  {
+    if (_window_stale)
+    {
+      rebuildWindow();
+      return;
+    }
+    const size_t last_id = _popped_chunks + _chunks.size() - 1;
+    const MinMax& last = _chunks.back()->total;
+    while (!_window_min.empty() && chunkTotal(_window_min.back()).min >= last.min)
+    {
+      _window_min.pop_back();
+    }
+    _window_min.push_back(last_id);
+    while (!_window_max.empty() && chunkTotal(_window_max.back()).max <= last.max)
+    {
+      _window_max.pop_back();
+    }
+    _window_max.push_back(last_id);
+  }
+
+  void rebuildWindow()
+  {
+    _window_min.clear();
+    _window_max.clear();
+    _window_stale = false;
+    const size_t count = _chunks.size();
+    for (size_t c = 0; c < count; c++)
+    {
+      const MinMax& total = _chunks[c]->total;
+      while (!_window_min.empty() && chunkTotal(_window_min.back()).min >= total.min)
+      {
+        _window_min.pop_back();
+      }
+      _window_min.push_back(_popped_chunks + c);
+      while (!_window_max.empty() && chunkTotal(_window_max.back()).max <= total.max)
+      {
+        _window_max.pop_back();
+      }
+      _window_max.push_back(_popped_chunks + c);
+    }
+  }
+
+  // Range of Y of the chunks from [chunk] (index in _chunks) to the last one.
+  MinMax windowRange(size_t chunk) const
+  {
+    const size_t id = _popped_chunks + chunk;
+    const auto min_it = std::lower_bound(_window_min.begin(), _window_min.end(), id);
+    const auto max_it = std::lower_bound(_window_max.begin(), _window_max.end(), id);
+    return { chunkTotal(*min_it).min, chunkTotal(*max_it).max };
+  }
+
+  std::deque<std::unique_ptr<Chunk>> _chunks;
+  // position of the first element inside _chunks.front()
+  size_t _front = 0;
+  size_t _size = 0;
+  BuiltinType _value_type = BuiltinType::FLOAT64;
+
+  // number of chunks removed by pop_front; ids in the queues are absolute
+  size_t _popped_chunks = 0;
+  std::deque<size_t> _window_min;
+  std::deque<size_t> _window_max;
+  // true if a sealed chunk was modified after the queues were updated: rangeY uses the
+  // totals of the chunks until the queues are rebuilt
+  bool _window_stale = false;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_CHUNKED_COLUMNS_H
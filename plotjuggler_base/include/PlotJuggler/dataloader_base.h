@@ -7,6 +7,10 @@
 #ifndef DATALOAD_TEMPLATE_H
 #define DATALOAD_TEMPLATE_H
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
 #include <QFile>
 
 #include "PlotJuggler/plotdata.h"
@@ -25,6 +29,49 @@ struct FileLoadInfo
   QDomDocument plugin_config;
 };
 
+/**
+ * @brief Shared by a background job of a DataLoader (see DataLoader::setBackgroundJob)
+ * and the application, that may run the jobs of several files at the same time.
+ */
+class LoadingTask
+{
+public:
+  /// Locked by the job while it writes into its destination.
+  std::mutex& mutex()
+  {
+    return _mutex;
+  }
+
+  /// Thread-safe. Ask the job to stop.
+  void cancel()
+  {
+    _canceled = true;
+  }
+
+  bool isCanceled() const
+  {
+    return _canceled;
+  }
+
+  /// Thread-safe. Work done and total work of the job, in any unit.
+  void setProgress(size_t done, size_t total)
+  {
+    _progress_done = done;
+    _progress_total = total;
+  }
+
+  std::pair<size_t, size_t> progress() const
+  {
+    return { _progress_done, _progress_total };
+  }
+
+private:
+  std::mutex _mutex;
+  std::atomic_bool _canceled{ false };
+  std::atomic<size_t> _progress_done{ 0 };
+  std::atomic<size_t> _progress_total{ 0 };
+};
+
 /**
  * @brief The DataLoader plugin type is used to load files.
  *
@@ -43,6 +90,35 @@ public:
 
   virtual bool readDataFromFile(FileLoadInfo* fileload_info, PlotDataMapRef& destination) = 0;
 
+  /**
+   * @brief Part of the loading that readDataFromFile() leaves to a worker thread.
+   *
+   * readDataFromFile() is called in the GUI thread. A loader may do there only what
+   * needs the GUI (dialogs, creation of the parsers) and pass the rest of the work,
+   * usually the slow part, to setBackgroundJob(). The application runs the job in a
+   * worker thread and, in the meantime, moves the points loaded so far into the plots.
+   * The destination of readDataFromFile() is valid until the job returns.
+   *
+   * The job must not use any widget and must lock LoadingTask::mutex() while it writes
+   * into the destination of readDataFromFile(). It should report its progress and stop
+   * as soon as LoadingTask::isCanceled() is true. It returns false if the loading failed.
+   *
+   * Canceling is not a failure: the job returns true and the points loaded so far,
+   * that the user may already see in the plots, are kept as the content of the file.
+   *
+   * The jobs of different files may run at the same time, even if they were created by
+   * the same loader: a job must not change the members of the loader.
+   */
+  using BackgroundJob = std::function<bool(LoadingTask&)>;
+
+  /// Called by the application after readDataFromFile(). Empty if there is no job.
+  BackgroundJob takeBackgroundJob()
+  {
+    BackgroundJob job;
+    std::swap(job, _background_job);
+    return job;
+  }
+
   void setParserFactories(ParserFactories* parsers)
   {
     _parser_factories = parsers;
@@ -53,8 +129,16 @@ public:
     return _parser_factories;
   }
 
+protected:
+  void setBackgroundJob(BackgroundJob job)
+  {
+    _background_job = std::move(job);
+  }
+
 private:
   ParserFactories* _parser_factories = nullptr;
+
+  BackgroundJob _background_job;
 };
 
 using DataLoaderPtr = std::shared_ptr<DataLoader>;
@@ -7,11 +7,15 @@
 #ifndef DATA_STREAMER_TEMPLATE_H
 #define DATA_STREAMER_TEMPLATE_H
 
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <mutex>
 #include <unordered_set>
 #include "PlotJuggler/plotdata.h"
 #include "PlotJuggler/pj_plugin.h"
 #include "PlotJuggler/messageparser_base.h"
+#include "PlotJuggler/spsc_queue.h"
 
 namespace PJ
 {
@@ -21,6 +25,9 @@ namespace PJ
  * Important. To avoid problems with thread safety, ANY update to
  * dataMap(), which share its elements with the main application, must be protected
  * using the mutex().
+ *
+ * Alternatively, plugins that parse all the messages in a single thread can use
+ * ingestBuffer() and publishIngestBuffer(), that don't need any lock.
  */
 class DataStreamer : public PlotJugglerPlugin
 {
@@ -76,6 +83,43 @@ public:
     return _data_map;
   }
 
+  /**
+   * @brief Lock-free alternative to dataMap(), for plugins that write the data in a
+   * single thread (the "producer"). That thread can use this buffer, for instance
+   * to create the parsers, without locking mutex().
+   * The new points are passed to the main application by publishIngestBuffer().
+   */
+  PlotDataMapRef& ingestBuffer()
+  {
+    return _ingest_buffer;
+  }
+
+  /**
+   * @brief To be called by the producer thread, for instance periodically.
+   *
+   * The new points of ingestBuffer() are moved (O(1) per series) into a batch, that
+   * is passed to the main application through a single-producer/single-consumer queue.
+   * Batches are recycled, therefore this doesn't allocate memory once warmed up.
+   *
+   * It never blocks. Returns false if there was nothing to publish or if the main
+   * application is late: in that case the points are published by the next call.
+   */
+  bool publishIngestBuffer();
+
+  /**
+   * @brief To be called by the main application. The published batches are passed to
+   * [consumer], that must move all their points, and then recycled.
+   * A single call consumes at most the batches that fit in the queue.
+   */
+  void consumeIngestedData(const std::function<void(PlotDataMapRef&)>& consumer);
+
+  /**
+   * @brief Drop the points of ingestBuffer() and the batches not consumed yet, for
+   * instance the ones left by a previous session. Called by the main application before
+   * start(), when the producer thread is not running.
+   */
+  void discardIngestedData();
+
   void setParserFactories(ParserFactories* parsers);
 
   const ParserFactories* parserFactories() const;
@@ -105,6 +149,19 @@ private:
   PlotDataMapRef _data_map;
   QAction* _start_streamer;
   ParserFactories* _parser_factories = nullptr;
+
+  static constexpr size_t INGEST_QUEUE_SIZE = 64;
+  using IngestBatch = std::unique_ptr<PlotDataMapRef>;
+
+  // accessed only by the producer thread
+  PlotDataMapRef _ingest_buffer;
+  IngestBatch _spare_batch;
+  size_t _allocated_batches = 0;
+  double _ingest_range_x = std::numeric_limits<double>::max();
+
+  std::atomic<double> _max_range_x{ std::numeric_limits<double>::max() };
+  SPSCQueue<IngestBatch, INGEST_QUEUE_SIZE> _published_batches;
+  SPSCQueue<IngestBatch, INGEST_QUEUE_SIZE> _recycled_batches;
 };
 
 using DataStreamerPtr = std::shared_ptr<DataStreamer>;
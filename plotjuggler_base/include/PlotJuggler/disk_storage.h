@@ -0,0 +1,113 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_DISK_STORAGE_H
+#define PJ_DISK_STORAGE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PJ
+{
+/**
+ * @brief Memory-mapped scratch files used to store the sealed chunks of the series,
+ * when the data does not fit in RAM.
+ *
+ * The files are split in slots of SLOT_SIZE bytes. A chunk moved to a slot is
+ * accessed exactly like a chunk in memory; it is up to the page cache of the OS to
+ * decide which pages stay resident. Only the samples are moved: indexes and min/max
+ * summaries stay in memory.
+ *
+ * There is a single instance shared by the application and all the plugins.
+ */
+class DiskStorage
+{
+public:
+  static constexpr size_t SLOT_SIZE = 64 * 1024;
+
+  /// RAII handle to a slot. The slot is released when the handle is destroyed.
+  class Slot
+  {
+  public:
+    Slot() = default;
+    ~Slot();
+
+    Slot(const Slot&) = delete;
+    Slot& operator=(const Slot&) = delete;
+
+    Slot(Slot&& other);
+    Slot& operator=(Slot&& other);
+
+    bool valid() const
+    {
+      return _data != nullptr;
+    }
+
+    uint8_t* data() const
+    {
+      return _data;
+    }
+
+  private:
+    friend class DiskStorage;
+    DiskStorage* _owner = nullptr;
+    uint8_t* _data = nullptr;
+    uint32_t _segment = 0;
+    uint32_t _index = 0;
+
+    void release();
+  };
+
+  DiskStorage();
+  ~DiskStorage();
+
+  DiskStorage(const DiskStorage&) = delete;
+  DiskStorage& operator=(const DiskStorage&) = delete;
+
+  static DiskStorage* instance();
+
+  bool isEnabled() const
+  {
+    return _enabled;
+  }
+
+  /// Chunks already in memory are not moved; the option affects only new chunks.
+  void setEnabled(bool enabled)
+  {
+    _enabled = enabled;
+  }
+
+  /// Folder where the scratch files are created. Default: the temporary folder of the OS.
+  void setDirectory(const std::string& path);
+
+  /// Returns an invalid Slot if the storage is disabled or the scratch file can not be created.
+  Slot allocate();
+
+  /// Number of bytes currently stored on disk.
+  size_t usedBytes() const;
+
+private:
+  struct Segment;
+
+  void release(uint32_t segment, uint32_t index);
+  bool addSegment();
+
+  std::atomic_bool _enabled{ false };
+  mutable std::mutex _mutex;
+  std::string _directory;
+  std::vector<std::unique_ptr<Segment>> _segments;
+  std::vector<std::pair<uint32_t, uint32_t>> _free_slots;
+  size_t _used_slots = 0;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_DISK_STORAGE_H
@@ -130,6 +130,44 @@ protected:
     return _plot_data.getOrCreateStringSeries(key, _group);
   }
 
+  /// Handle of a series, that can be used instead of its name (see registerSeries).
+  using SeriesHandle = SeriesId;
+
+  /**
+   * @brief Resolve the name of a series once, typically when the schema of the
+   * message (or the position of a field) is known, and then use the handle for every
+   * message. Unlike getSeries(key), getSeries(handle) and push() don't need to build
+   * and hash the name.
+   */
+  SeriesHandle registerSeries(const std::string& key)
+  {
+    const SeriesId id = PlotDataMapRef::getSeriesId(key);
+    _plot_data.getOrCreateNumeric(id, _group);
+    return id;
+  }
+
+  SeriesHandle registerStringSeries(const std::string& key)
+  {
+    const SeriesId id = PlotDataMapRef::getSeriesId(key);
+    _plot_data.getOrCreateStringSeries(id, _group);
+    return id;
+  }
+
+  PlotData& getSeries(SeriesHandle handle)
+  {
+    return _plot_data.getOrCreateNumeric(handle, _group);
+  }
+
+  StringSeries& getStringSeries(SeriesHandle handle)
+  {
+    return _plot_data.getOrCreateStringSeries(handle, _group);
+  }
+
+  void push(SeriesHandle handle, double timestamp, double value)
+  {
+    getSeries(handle).pushBack({ timestamp, value });
+  }
+
 private:
   bool _clamp_large_arrays = false;
   unsigned _max_array_size = 10000;
@@ -146,7 +146,7 @@ inline uint32_t unpack_number(const uint8_t* data, T& value)
   return sizeof(T);
 }
 
-uint32_t unpack_number_into_double(const uint8_t* data, BuiltinType type, double& value)
+inline uint32_t unpack_number_into_double(const uint8_t* data, BuiltinType type, double& value)
 {
   switch (type)
   {
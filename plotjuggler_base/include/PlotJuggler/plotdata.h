@@ -10,6 +10,7 @@
 #include "plotdatabase.h"
 #include "timeseries.h"
 #include "stringseries.h"
+#include "series_map.h"
 #include <any>
 #include <unordered_set>
 
@@ -27,10 +28,10 @@ using PlotDataAny = TimeseriesBase<std::any>;
 // obsolete. For back compatibility only
 // using PlotDataMap = std::unordered_map<std::string, PlotData>;
 
-using TimeseriesMap = std::unordered_map<std::string, PlotData>;
-using ScatterXYMap = std::unordered_map<std::string, PlotDataXY>;
-using AnySeriesMap = std::unordered_map<std::string, PlotDataAny>;
-using StringSeriesMap = std::unordered_map<std::string, StringSeries>;
+using TimeseriesMap = SeriesMap<PlotData>;
+using ScatterXYMap = SeriesMap<PlotDataXY>;
+using AnySeriesMap = SeriesMap<PlotDataAny>;
+using StringSeriesMap = SeriesMap<StringSeries>;
 
 struct PlotDataMapRef
 {
@@ -68,6 +69,17 @@ struct PlotDataMapRef
 
   PlotDataAny& getOrCreateUserDefined(const std::string& name, PlotGroup::Ptr group = {});
 
+  /// Handle of the series [name], valid in any PlotDataMapRef (see SeriesNames).
+  /// Functions that accept a SeriesId find the series without hashing its name.
+  static SeriesId getSeriesId(const std::string& name)
+  {
+    return SeriesNames::instance()->intern(name);
+  }
+
+  PlotData& getOrCreateNumeric(SeriesId id, PlotGroup::Ptr group = {});
+
+  StringSeries& getOrCreateStringSeries(SeriesId id, PlotGroup::Ptr group = {});
+
   PlotGroup::Ptr getOrCreateGroup(const std::string& name);
 
   std::unordered_set<std::string> getAllNames() const;
@@ -80,40 +92,29 @@ struct PlotDataMapRef
 };
 
 template <typename Value>
-inline void AddPrefixToPlotData(const std::string& prefix,
-                                std::unordered_map<std::string, Value>& data)
+inline void AddPrefixToPlotData(const std::string& prefix, SeriesMap<Value>& data)
 {
   if (prefix.empty())
   {
     return;
   }
 
-  std::vector<std::string> temp_key;
-  temp_key.reserve(data.size());
-  std::vector<Value> temp_value;
-  temp_value.reserve(data.size());
-
-  for (auto& it : data)
-  {
+  // only the nodes of the map are replaced: the points are not copied
+  data.renameAll([&prefix](const std::string& name) {
     std::string key;
-    key.reserve(prefix.size() + 2 + it.first.size());
-    key = (it.first.front() == '/') ? (prefix + it.first) : (prefix + "/" + it.first);
-
-    temp_key.emplace_back(key);
-    temp_value.emplace_back(std::move(it.second));
-  }
-
-  data.clear();
-
-  for (size_t i = 0; i < temp_key.size(); i++)
+    key.reserve(prefix.size() + 1 + name.size());
+    key = prefix;
+    if (name.empty() || name.front() != '/')
+    {
+      key += '/';
+    }
+    key += name;
+    return key;
+  });
+
+  for (auto& [name, series] : data)
   {
-    const std::string& key = temp_key[i];
-
-    auto it = data.emplace(std::piecewise_construct, std::forward_as_tuple(key),
-                           std::forward_as_tuple(key, PlotGroup::Ptr()))
-                  .first;
-
-    it->second = std::move(temp_value[i]);
+    series.setPlotName(name);
   }
 }
 
@@ -7,9 +7,9 @@
 #ifndef PJ_PLOTDATA_BASE_H
 #define PJ_PLOTDATA_BASE_H
 
+#include <algorithm>
 #include <memory>
 #include <string>
-#include <deque>
 #include <type_traits>
 #include <cmath>
 #include <cstdlib>
@@ -19,6 +19,8 @@
 #include <QVariant>
 #include <QtGlobal>
 
+#include "chunked_columns.h"
+
 namespace PJ
 {
 struct Range
@@ -112,9 +114,16 @@ public:
     return (it == _attributes.end()) ? QVariant() : it->second;
   }
 
+  /// Timestamps shared by the series of this group (see ColumnPool).
+  ColumnPool& columnPool()
+  {
+    return _column_pool;
+  }
+
 private:
   const std::string _name;
   Attributes _attributes;
+  ColumnPool _column_pool;
 };
 
 // A Generic series of points
@@ -139,12 +148,86 @@ public:
     ASYNC_BUFFER_CAPACITY = 1024
   };
 
-  typedef typename std::deque<Point>::iterator Iterator;
-  typedef typename std::deque<Point>::const_iterator ConstIterator;
+  using Storage = ChunkedColumns<TypeX, Value, Point>;
+
+  /**
+   * @brief Reference to a point, returned by the non-const accessors.
+   *
+   * Points are stored in columns (see ChunkedColumns), not as objects: reading the
+   * reference (or its x and y) copies the values, assigning it writes them back with
+   * setPoint(). New code should use the const accessors and setPoint() directly.
+   */
+  class PointRef
+  {
+  public:
+    template <typename T>
+    class Field
+    {
+    public:
+      Field(PlotDataBase* data, size_t index, T Point::*member)
+        : _data(data), _index(index), _member(member)
+      {
+      }
+
+      operator T() const
+      {
+        return _data->_points[_index].*_member;
+      }
+
+      const Field& operator=(const T& value) const
+      {
+        Point p = _data->_points[_index];
+        p.*_member = value;
+        _data->setPoint(_index, p);
+        return *this;
+      }
+
+      const Field& operator=(const Field& other) const
+      {
+        return *this = T(other);
+      }
+
+    private:
+      PlotDataBase* _data;
+      size_t _index;
+      T Point::*_member;
+    };
+
+    Field<TypeX> x;
+    Field<Value> y;
+
+    PointRef(PlotDataBase* data, size_t index)
+      : x(data, index, &Point::x), y(data, index, &Point::y), _data(data), _index(index)
+    {
+    }
+
+    operator Point() const
+    {
+      return _data->_points[_index];
+    }
+
+    const PointRef& operator=(const Point& p) const
+    {
+      _data->setPoint(_index, p);
+      return *this;
+    }
+
+    const PointRef& operator=(const PointRef& other) const
+    {
+      return *this = Point(other);
+    }
+
+  private:
+    PlotDataBase* _data;
+    size_t _index;
+  };
+
+  typedef IndexIterator<PlotDataBase, Point> Iterator;
+  typedef IndexIterator<const PlotDataBase, Point> ConstIterator;
   typedef Value ValueT;
 
   PlotDataBase(const std::string& name, PlotGroup::Ptr group)
-    : _name(name), _range_x_dirty(true), _range_y_dirty(true), _group(group)
+    : _name(name), _range_x_dirty(true), _group(group)
   {
   }
 
@@ -158,27 +241,73 @@ public:
   {
     _points = other._points;
     _range_x = other._range_x;
-    _range_y = other._range_y;
     _range_x_dirty = other._range_x_dirty;
-    _range_y_dirty = other._range_y_dirty;
+    _generation = std::max(_generation, other._generation) + 1;
   }
 
   void clonePoints(PlotDataBase&& other)
   {
     _points = std::move(other._points);
     _range_x = other._range_x;
-    _range_y = other._range_y;
     _range_x_dirty = other._range_x_dirty;
-    _range_y_dirty = other._range_y_dirty;
+    _generation = std::max(_generation, other._generation) + 1;
+    other._generation++;
+  }
+
+  /// Move all the points of [other] after the existing ones. Entire chunks of
+  /// points are moved instead of being copied, when possible (see ChunkedColumns::splice).
+  void splicePoints(PlotDataBase&& other)
+  {
+    if (other._points.empty())
+    {
+      return;
+    }
+    if (_points.empty())
+    {
+      clonePoints(std::move(other));
+      return;
+    }
+    if constexpr (std::is_arithmetic_v<TypeX>)
+    {
+      if (!_range_x_dirty && !other._range_x_dirty)
+      {
+        _range_x.min = std::min(_range_x.min, other._range_x.min);
+        _range_x.max = std::max(_range_x.max, other._range_x.max);
+      }
+      else
+      {
+        _range_x_dirty = true;
+      }
+    }
+    _points.splice(std::move(other._points), columnPool());
+    other._range_x_dirty = true;
+    _generation++;
+    other._generation++;
   }
 
   virtual ~PlotDataBase() = default;
 
+  /**
+   * @brief Counter incremented every time the points are modified.
+   *
+   * Two equal values mean that the points did not change in between: it is used to
+   * skip the work that depends only on the points (caches, rescaling, painting).
+   */
+  uint64_t generation() const
+  {
+    return _generation;
+  }
+
   const std::string& plotName() const
   {
     return _name;
   }
 
+  void setPlotName(const std::string& name)
+  {
+    _name = name;
+  }
+
   const PlotGroup::Ptr& group() const
   {
     return _group;
@@ -199,31 +328,52 @@ public:
     return false;
   }
 
-  const Point& at(size_t index) const
+  // Returned as const, so that "auto& p = at(i)" binds the temporary copy of the point.
+  const Point at(size_t index) const
   {
     return _points[index];
   }
 
-  Point& at(size_t index)
+  const PointRef at(size_t index)
+  {
+    return PointRef(this, index);
+  }
+
+  const Point operator[](size_t index) const
   {
     return _points[index];
   }
 
-  const Point& operator[](size_t index) const
+  const PointRef operator[](size_t index)
   {
-    return at(index);
+    return PointRef(this, index);
   }
 
-  Point& operator[](size_t index)
+  // Overwrite an existing point. The caller is responsible for preserving the order in X.
+  void setPoint(size_t index, const Point& p)
   {
-    return at(index);
+    _points.set(index, p);
+    _range_x_dirty = true;
+    _generation++;
   }
 
   virtual void clear()
   {
     _points.clear();
     _range_x_dirty = true;
-    _range_y_dirty = true;
+    _generation++;
+  }
+
+  /// Native type of the values (i.e. the type in the original message or file).
+  /// When narrower than a double, the values are stored in memory with that width.
+  BuiltinType valueType() const
+  {
+    return _points.valueType();
+  }
+
+  void setValueType(BuiltinType type)
+  {
+    _points.setValueType(type);
   }
 
   const Attributes& attributes() const
@@ -251,34 +401,34 @@ public:
     return (it == _attributes.end()) ? QVariant() : it->second;
   }
 
-  const Point& front() const
+  Point front() const
   {
     return _points.front();
   }
 
-  const Point& back() const
+  Point back() const
   {
     return _points.back();
   }
 
   ConstIterator begin() const
   {
-    return _points.begin();
+    return ConstIterator(this, 0);
   }
 
   ConstIterator end() const
   {
-    return _points.end();
+    return ConstIterator(this, _points.size());
   }
 
   Iterator begin()
   {
-    return _points.begin();
+    return Iterator(this, 0);
   }
 
   Iterator end()
   {
-    return _points.end();
+    return Iterator(this, _points.size());
   }
 
   // template specialization for types that support compare operator
@@ -292,13 +442,16 @@ public:
       }
       if (_range_x_dirty)
       {
-        _range_x.min = front().x;
-        _range_x.max = _range_x.min;
-        for (const auto& p : _points)
-        {
-          _range_x.min = std::min(_range_x.min, p.x);
-          _range_x.max = std::max(_range_x.max, p.x);
-        }
+        double min_x = _points.xAt(0);
+        double max_x = min_x;
+        _points.forEachSpan(0, _points.size(), [&](const TypeX* x, const Value*, size_t count) {
+          for (size_t i = 0; i < count; i++)
+          {
+            min_x = std::min<double>(min_x, x[i]);
+            max_x = std::max<double>(max_x, x[i]);
+          }
+        });
+        _range_x = { min_x, max_x };
         _range_x_dirty = false;
       }
       return _range_x;
@@ -309,24 +462,16 @@ public:
   // template specialization for types that support compare operator
   virtual RangeOpt rangeY() const
   {
-    if constexpr (std::is_arithmetic_v<Value>)
+    return rangeYInIndices(0, _points.size());
+  }
+
+  /// Range of Y of the points in the interval of indices [first, last).
+  /// It uses the min/max summaries of the storage and never scans the entire series.
+  RangeOpt rangeYInIndices(size_t first, size_t last) const
+  {
+    if (auto range = _points.rangeY(first, last))
     {
-      if (_points.empty())
-      {
-        return std::nullopt;
-      }
-      if (_range_y_dirty)
-      {
-        _range_y.min = front().y;
-        _range_y.max = _range_y.min;
-        for (const auto& p : _points)
-        {
-          _range_y.min = std::min(_range_y.min, p.y);
-          _range_y.max = std::max(_range_y.max, p.y);
-        }
-        _range_y_dirty = false;
-      }
-      return _range_y;
+      return Range{ range->min, range->max };
     }
     return std::nullopt;
   }
@@ -353,10 +498,10 @@ public:
       {
         return;  // skip
       }
-      pushUpdateRangeY(p);
     }
 
-    _points.emplace_back(p);
+    _points.push_back(p, columnPool());
+    _generation++;
   }
 
   virtual void insert(Iterator it, Point&& p)
@@ -375,44 +520,51 @@ public:
       {
         return;  // skip
       }
-      pushUpdateRangeY(p);
     }
 
-    _points.insert(it, p);
+    _points.insert(it.index(), p);
+    _generation++;
   }
 
   virtual void popFront()
   {
-    const auto& p = _points.front();
-
     if constexpr (std::is_arithmetic_v<TypeX>)
     {
-      if (!_range_x_dirty && (p.x == _range_x.max || p.x == _range_x.min))
+      const TypeX x = _points.xAt(0);
+      if (!_range_x_dirty && (x == _range_x.max || x == _range_x.min))
       {
         _range_x_dirty = true;
       }
     }
+    _points.pop_front();
+    _generation++;
+  }
 
-    if constexpr (std::is_arithmetic_v<Value>)
+  /// Remove the first [count] points at once.
+  virtual void popFront(size_t count)
+  {
+    if (count > 0)
     {
-      if (!_range_y_dirty && (p.y == _range_y.max || p.y == _range_y.min))
-      {
-        _range_y_dirty = true;
-      }
+      _range_x_dirty = true;
+      _points.pop_front(count);
+      _generation++;
     }
-    _points.pop_front();
   }
 
 protected:
   std::string _name;
   Attributes _attributes;
-  std::deque<Point> _points;
+  Storage _points;
 
   mutable Range _range_x;
-  mutable Range _range_y;
   mutable bool _range_x_dirty;
-  mutable bool _range_y_dirty;
   mutable std::shared_ptr<PlotGroup> _group;
+  uint64_t _generation = 0;
+
+  ColumnPool* columnPool() const
+  {
+    return _group ? &_group->columnPool() : nullptr;
+  }
 
   // template specialization for types that support compare operator
   virtual void pushUpdateRangeX(const Point& p)
@@ -435,33 +587,6 @@ protected:
         {
           _range_x.min = p.x;
         }
-        else
-        {
-          _range_x_dirty = true;
-        }
-      }
-    }
-  }
-
-  // template specialization for types that support compare operator
-  virtual void pushUpdateRangeY(const Point& p)
-  {
-    if constexpr (std::is_arithmetic_v<Value>)
-    {
-      if (!_range_y_dirty)
-      {
-        if (p.y > _range_y.max)
-        {
-          _range_y.max = p.y;
-        }
-        else if (p.y < _range_y.min)
-        {
-          _range_y.min = p.y;
-        }
-        else
-        {
-          _range_y_dirty = true;
-        }
       }
     }
   }
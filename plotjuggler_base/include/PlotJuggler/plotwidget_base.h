@@ -135,6 +135,10 @@ public:
     return _line_width;
   }
 
+  /// With parallel rendering, replot() only schedules the rendering, that starts when the
+  /// control returns to the event loop. This renders the scheduled plots immediately.
+  static void renderScheduledPlots();
+
 public slots:
 
   void replot();
@@ -0,0 +1,382 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SERIES_MAP_H
+#define PJ_SERIES_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PJ
+{
+/// Integer handle of the name of a series. See SeriesNames.
+using SeriesId = uint32_t;
+
+constexpr SeriesId INVALID_SERIES_ID = std::numeric_limits<SeriesId>::max();
+
+/**
+ * @brief Global table of the names of the series ("string interning").
+ *
+ * Each name is associated to a SeriesId, that never changes and is the same in every
+ * PlotDataMapRef. Names are never removed: memory grows with the number of distinct
+ * names, not with the number of series that are created and deleted.
+ *
+ * It is thread-safe. There is a single instance shared by the application and all
+ * the plugins.
+ */
+class SeriesNames
+{
+public:
+  static SeriesNames* instance();
+
+  /// ID of the name, created if it doesn't exist yet.
+  SeriesId intern(const std::string& name)
+  {
+    {
+      std::shared_lock lock(_mutex);
+      auto it = _ids.find(name);
+      if (it != _ids.end())
+      {
+        return it->second;
+      }
+    }
+    std::unique_lock lock(_mutex);
+    auto [it, inserted] = _ids.try_emplace(name, SeriesId(_names.size()));
+    if (inserted)
+    {
+      _names.push_back(&it->first);
+    }
+    return it->second;
+  }
+
+  /// ID of the name, or INVALID_SERIES_ID if it was never interned.
+  SeriesId find(const std::string& name) const
+  {
+    std::shared_lock lock(_mutex);
+    auto it = _ids.find(name);
+    return (it == _ids.end()) ? INVALID_SERIES_ID : it->second;
+  }
+
+  /// The reference is valid for the entire life of the application.
+  const std::string& name(SeriesId id) const
+  {
+    std::shared_lock lock(_mutex);
+    return *_names[id];
+  }
+
+private:
+  mutable std::shared_mutex _mutex;
+  std::unordered_map<std::string, SeriesId> _ids;
+  std::vector<const std::string*> _names;
+};
+
+/**
+ * @brief Container of series indexed by name, used by PlotDataMapRef.
+ *
+ * Its interface is a subset of std::unordered_map<std::string, T>, but:
+ *
+ * - the series are stored in a dense vector and iteration is a linear scan;
+ * - a series can also be found by SeriesId, in O(1) and without hashing the name;
+ * - erase() moves the last series in the position of the erased one.
+ *
+ * Each map has its own index of names and SeriesIds, that grows with the number of
+ * its series: lookups never take the lock of SeriesNames, only emplace() of a new series
+ * and renameAll() do.
+ *
+ * As in std::unordered_map, references to the series are never invalidated, unless
+ * the series itself is erased.
+ */
+template <typename T>
+class SeriesMap
+{
+public:
+  using key_type = std::string;
+  using mapped_type = T;
+  using value_type = std::pair<const std::string, T>;
+
+private:
+  using Storage = std::vector<std::unique_ptr<value_type>>;
+
+public:
+  template <bool IS_CONST>
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = SeriesMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IS_CONST, const value_type*, value_type*>;
+    using reference = std::conditional_t<IS_CONST, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    explicit Iterator(typename Storage::const_iterator it) : _it(it)
+    {
+    }
+
+    // iterator is convertible to const_iterator
+    template <bool OTHER_CONST, typename = std::enable_if_t<IS_CONST && !OTHER_CONST>>
+    Iterator(const Iterator<OTHER_CONST>& other) : _it(other.base())
+    {
+    }
+
+    reference operator*() const
+    {
+      return **_it;
+    }
+
+    pointer operator->() const
+    {
+      return _it->get();
+    }
+
+    Iterator& operator++()
+    {
+      ++_it;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator prev = *this;
+      ++_it;
+      return prev;
+    }
+
+    Iterator operator+(std::ptrdiff_t offset) const
+    {
+      return Iterator(_it + offset);
+    }
+
+    bool operator==(const Iterator& other) const
+    {
+      return _it == other._it;
+    }
+
+    bool operator!=(const Iterator& other) const
+    {
+      return _it != other._it;
+    }
+
+    typename Storage::const_iterator base() const
+    {
+      return _it;
+    }
+
+  private:
+    typename Storage::const_iterator _it;
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  iterator begin()
+  {
+    return iterator(_series.cbegin());
+  }
+
+  iterator end()
+  {
+    return iterator(_series.cend());
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(_series.cbegin());
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(_series.cend());
+  }
+
+  size_t size() const
+  {
+    return _series.size();
+  }
+
+  bool empty() const
+  {
+    return _series.empty();
+  }
+
+  iterator find(SeriesId id)
+  {
+    return iterator(_series.cbegin() + position(id));
+  }
+
+  const_iterator find(SeriesId id) const
+  {
+    return const_iterator(_series.cbegin() + position(id));
+  }
+
+  iterator find(const std::string& name)
+  {
+    return iterator(_series.cbegin() + position(name));
+  }
+
+  const_iterator find(const std::string& name) const
+  {
+    return const_iterator(_series.cbegin() + position(name));
+  }
+
+  size_t count(const std::string& name) const
+  {
+    return (find(name) == end()) ? 0 : 1;
+  }
+
+  /// SeriesId of the element pointed by [it].
+  SeriesId id(const_iterator it) const
+  {
+    return _ids[size_t(it.base() - _series.cbegin())];
+  }
+
+  /// Same as std::unordered_map::emplace(std::piecewise_construct, key, args)
+  template <typename KeyTuple, typename ArgsTuple>
+  std::pair<iterator, bool> emplace(std::piecewise_construct_t, KeyTuple&& key,
+                                    ArgsTuple&& args)
+  {
+    const std::string& name = std::get<0>(key);
+    auto it = find(name);
+    if (it != end())
+    {
+      return { it, false };
+    }
+    const SeriesId id = SeriesNames::instance()->intern(name);
+    _series.push_back(std::make_unique<value_type>(
+        std::piecewise_construct, std::forward<KeyTuple>(key), std::forward<ArgsTuple>(args)));
+    _ids.push_back(id);
+    index(_series.size() - 1);
+    return { iterator(std::prev(_series.cend())), true };
+  }
+
+  /// Returns the iterator to the series that took the place of the erased one.
+  iterator erase(const_iterator it)
+  {
+    const size_t pos = size_t(it.base() - _series.cbegin());
+    _by_name.erase(_series[pos]->first);
+    _by_id.erase(_ids[pos]);
+    if (pos + 1 < _series.size())
+    {
+      _series[pos] = std::move(_series.back());
+      _ids[pos] = _ids.back();
+      index(pos);
+    }
+    _series.pop_back();
+    _ids.pop_back();
+    return iterator(_series.cbegin() + pos);
+  }
+
+  iterator erase(iterator it)
+  {
+    return erase(const_iterator(it));
+  }
+
+  size_t erase(const std::string& name)
+  {
+    auto it = find(name);
+    if (it == end())
+    {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  void clear()
+  {
+    _series.clear();
+    _ids.clear();
+    _by_name.clear();
+    _by_id.clear();
+  }
+
+  /**
+   * @brief Rename every element to new_name(old_name). The elements are moved into
+   * the new nodes: references to them are invalidated, but their order is preserved.
+   *
+   * If several elements get the same name, the last one replaces the others, as if
+   * the elements were assigned to the new names one by one.
+   */
+  template <typename NameFunc>
+  void renameAll(const NameFunc& new_name)
+  {
+    Storage series;
+    series.reserve(_series.size());
+    std::vector<SeriesId> ids;
+    ids.reserve(_ids.size());
+
+    // the keys of _by_name point to the old nodes: the index is rebuilt at the end
+    _by_name.clear();
+    _by_id.clear();
+    for (auto& node : _series)
+    {
+      std::string name = new_name(node->first);
+      const SeriesId id = SeriesNames::instance()->intern(name);
+      node = std::make_unique<value_type>(std::move(name), std::move(node->second));
+
+      auto [id_it, inserted] = _by_id.try_emplace(id, uint32_t(series.size()));
+      if (!inserted)
+      {
+        series[id_it->second] = std::move(node);
+        continue;
+      }
+      series.push_back(std::move(node));
+      ids.push_back(id);
+    }
+    _series.swap(series);
+    _ids.swap(ids);
+    for (size_t pos = 0; pos < _series.size(); pos++)
+    {
+      _by_name.emplace(_series[pos]->first, uint32_t(pos));
+    }
+  }
+
+private:
+  // position in _series, or _series.size() if not found
+  size_t position(SeriesId id) const
+  {
+    auto it = _by_id.find(id);
+    return (it == _by_id.end()) ? _series.size() : it->second;
+  }
+
+  size_t position(std::string_view name) const
+  {
+    auto it = _by_name.find(name);
+    return (it == _by_name.end()) ? _series.size() : it->second;
+  }
+
+  // add (or update) the element at position [pos] to the indexes
+  void index(size_t pos)
+  {
+    _by_name[_series[pos]->first] = uint32_t(pos);
+    _by_id[_ids[pos]] = uint32_t(pos);
+  }
+
+  Storage _series;
+  // SeriesId of the elements of _series
+  std::vector<SeriesId> _ids;
+  // position in _series of each name and of each SeriesId. The keys of _by_name refer
+  // to the names stored in the nodes of _series. Both have the size of this map.
+  std::unordered_map<std::string_view, uint32_t> _by_name;
+  std::unordered_map<SeriesId, uint32_t> _by_id;
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SERIES_MAP_H
@@ -0,0 +1,67 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef PJ_SPSC_QUEUE_H
+#define PJ_SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace PJ
+{
+/**
+ * @brief Bounded lock-free queue, with a single producer thread and a single
+ * consumer thread. Neither of them ever blocks.
+ *
+ * CAPACITY must be a power of two.
+ */
+template <typename T, size_t CAPACITY>
+class SPSCQueue
+{
+  static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0,
+                "CAPACITY must be a power of two");
+
+public:
+  /// Producer only. Returns false if the queue is full; in that case [value] is not moved.
+  bool push(T&& value)
+  {
+    const size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == CAPACITY)
+    {
+      return false;
+    }
+    _buffer[tail & MASK] = std::move(value);
+    _tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer only. Returns false if the queue is empty.
+  bool pop(T& value)
+  {
+    const size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+    value = std::move(_buffer[head & MASK]);
+    _head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  static constexpr size_t MASK = CAPACITY - 1;
+
+  std::array<T, CAPACITY> _buffer;
+  // on different cache lines, to avoid false sharing between the two threads
+  alignas(64) std::atomic<size_t> _head{ 0 };
+  alignas(64) std::atomic<size_t> _tail{ 0 };
+};
+
+}  // namespace PJ
+
+#endif  // PJ_SPSC_QUEUE_H
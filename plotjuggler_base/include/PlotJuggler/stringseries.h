@@ -80,7 +80,7 @@ public:
     {
       return std::nullopt;
     }
-    return getString(_points[index].y);
+    return getString(_points.yAt(index));
   }
 
   void clonePoints(StringSeries&& other)
@@ -97,6 +97,9 @@ public:
     PlotDataBase<double, StringDictIndex>::clonePoints(other);
   }
 
+  // the indices of other refer to its own dictionary: the strings must be pushed again
+  void splicePoints(StringSeries&& other) = delete;
+
 private:
   StringDictIndex internString(std::string_view str)
   {
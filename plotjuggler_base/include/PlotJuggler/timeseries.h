@@ -9,6 +9,7 @@
 
 #include "plotdatabase.h"
 #include <algorithm>
+#include <vector>
 
 namespace PJ
 {
@@ -49,12 +50,40 @@ public:
     return _max_range_x;
   }
 
+  /// Index of the point with X closest to [x], or -1 if the series is empty.
   int getIndexFromX(double x) const;
 
+  /// Same as getIndexFromX(x), but the search starts from [cursor], that is updated with
+  /// the result. Lookups with increasing (or decreasing) x, like a sweep over another
+  /// series, become amortized O(1). Any value of cursor is valid.
+  int getIndexFromX(double x, size_t& cursor) const;
+
+  /// Index of the first point with X not less than [x], or size() if there is none.
+  size_t lowerBoundIndex(double x) const
+  {
+    return _points.lowerBoundX(x);
+  }
+
+  /// Same as lowerBoundIndex(x), but the search starts from [hint].
+  size_t lowerBoundIndex(double x, size_t hint) const
+  {
+    return _points.lowerBoundX(x, hint);
+  }
+
+  // points are sorted by X: the range is given by the first and last point.
+  RangeOpt rangeX() const override
+  {
+    if (_points.empty())
+    {
+      return std::nullopt;
+    }
+    return Range{ _points.xAt(0), _points.xAt(_points.size() - 1) };
+  }
+
   std::optional<Value> getYfromX(double x) const
   {
     int index = getIndexFromX(x);
-    return (index < 0) ? std::nullopt : std::optional(_points[index].y);
+    return (index < 0) ? std::nullopt : std::optional(_points.yAt(index));
   }
 
   void pushBack(const Point& p) override
@@ -65,12 +94,11 @@ public:
 
   void pushBack(Point&& p) override
   {
-    bool need_sorting = (!_points.empty() && p.x < this->back().x);
+    bool need_sorting = (!_points.empty() && p.x < _points.xAt(_points.size() - 1));
 
     if (need_sorting)
     {
-      auto it = std::upper_bound(_points.begin(), _points.end(), p,
-                                 [](const auto& a, const auto& b) { return a.x < b.x; });
+      auto it = this->begin() + _points.upperBoundX(p.x);
       PlotDataBase<double, Value>::insert(it, std::move(p));
     }
     else
@@ -91,46 +119,88 @@ public:
     }
     if (!std::isinf(p.x) && !std::isnan(p.x))
     {
-      _points.push_back(std::move(p));
+      _points.push_back(p, this->columnPool());
+      this->_generation++;
     }
   }
 
-  void sort()
+  /**
+   * @brief Append [count] points, given as two arrays.
+   *
+   * Equivalent to calling pushBack for each point, but much faster when the points are
+   * sorted by X and follow the existing ones: the arrays are validated with a single
+   * pass and copied in bulk. Otherwise, it falls back to appendUnsorted.
+   * As in pushBack, points with NaN or infinite values are skipped.
+   */
+  void appendSorted(const double* x, const Value* y, size_t count);
+
+  /// Append [count] points in any order. The series is sorted only once, if needed.
+  void appendUnsorted(const double* x, const Value* y, size_t count);
+
+  /// Same as PlotDataBase::splicePoints, but all the points of [other] must be
+  /// newer than the last point of this series.
+  void splicePoints(TimeseriesBase&& other)
   {
-    std::sort(_points.begin(), _points.end(),
-              [](const auto& a, const auto& b) { return a.x < b.x; });
+    PlotDataBase<double, Value>::splicePoints(std::move(other));
+    trimRange();
+  }
 
-    Range range_x;
-    Range range_y;
+  void sort()
+  {
+    std::vector<Point> sorted(_points.begin(), _points.end());
+    std::sort(sorted.begin(), sorted.end(), TimeCompare);
 
-    for (const auto& p : _points)
+    _points.clear();
+    for (const auto& p : sorted)
     {
-      range_x.min = std::max(range_x.min, p.x);
-      range_x.max = std::min(range_x.max, p.x);
-
-      if constexpr (std::is_arithmetic_v<Value>)
-      {
-        range_y.min = std::max(range_y.min, p.y);
-        range_y.max = std::min(range_y.max, p.y);
-      }
+      _points.push_back(p, this->columnPool());
     }
-    this->_range_x = range_x;
-    this->_range_y = range_y;
-    this->_range_x_dirty = false;
-    this->_range_y_dirty = false;
+    this->_range_x_dirty = true;
+    this->_generation++;
     trimRange();
   }
 
 private:
+  int closestIndex(size_t lower_bound, double x) const;
+
+  static bool isValidPoint(double x, const Value& y)
+  {
+    if constexpr (std::is_arithmetic_v<Value>)
+    {
+      return std::isfinite(x) && std::isfinite(double(y));
+    }
+    return std::isfinite(x);
+  }
+
+  // Remove the points older than _max_range_x, with a single popFront(count).
   void trimRange()
   {
-    if (_max_range_x < std::numeric_limits<double>::max() && !_points.empty())
+    if (_max_range_x < std::numeric_limits<double>::max() && _points.size() > 2)
     {
-      auto const back_point_x = _points.back().x;
-      while (_points.size() > 2 && (back_point_x - _points.front().x) > _max_range_x)
+      const double back_point_x = _points.xAt(_points.size() - 1);
+      const auto expired = [&](size_t index) {
+        return (back_point_x - _points.xAt(index)) > _max_range_x;
+      };
+      // usually only a few points expire: check them one by one before searching
+      size_t count = 0;
+      while (count < 8 && count < _points.size() && expired(count))
       {
-        this->popFront();
+        count++;
       }
+      if (count == 8)
+      {
+        // the search may be off by one point, because of rounding
+        count = _points.lowerBoundX(back_point_x - _max_range_x, count);
+        while (count > 0 && !expired(count - 1))
+        {
+          count--;
+        }
+        while (count < _points.size() && expired(count))
+        {
+          count++;
+        }
+      }
+      this->popFront(std::min(count, _points.size() - 2));
     }
   }
 
@@ -142,6 +212,95 @@ private:
 
 //--------------------
 
+template <typename Value>
+inline void TimeseriesBase<Value>::appendSorted(const double* x, const Value* y, size_t count)
+{
+  if (count == 0)
+  {
+    return;
+  }
+  bool valid = true;
+  for (size_t i = 0; i < count; i++)
+  {
+    valid &= std::isfinite(x[i]);
+  }
+  if constexpr (std::is_arithmetic_v<Value>)
+  {
+    for (size_t i = 0; i < count; i++)
+    {
+      valid &= std::isfinite(double(y[i]));
+    }
+  }
+  bool sorted = _points.empty() || !(x[0] < _points.xAt(_points.size() - 1));
+  for (size_t i = 1; i < count; i++)
+  {
+    sorted &= !(x[i] < x[i - 1]);
+  }
+
+  if (!valid)
+  {
+    // remove the invalid points and try again
+    std::vector<double> valid_x;
+    std::vector<Value> valid_y;
+    valid_x.reserve(count);
+    valid_y.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+      if (isValidPoint(x[i], y[i]))
+      {
+        valid_x.push_back(x[i]);
+        valid_y.push_back(y[i]);
+      }
+    }
+    appendSorted(valid_x.data(), valid_y.data(), valid_x.size());
+    return;
+  }
+  if (!sorted)
+  {
+    appendUnsorted(x, y, count);
+    return;
+  }
+  _points.append(x, y, count, this->columnPool());
+  this->_range_x_dirty = true;
+  this->_generation++;
+  trimRange();
+}
+
+template <typename Value>
+inline void TimeseriesBase<Value>::appendUnsorted(const double* x, const Value* y,
+                                                  size_t count)
+{
+  std::vector<Point> points;
+  points.reserve(count);
+  for (size_t i = 0; i < count; i++)
+  {
+    if (isValidPoint(x[i], y[i]))
+    {
+      points.emplace_back(x[i], y[i]);
+    }
+  }
+  if (points.empty())
+  {
+    return;
+  }
+  std::stable_sort(points.begin(), points.end(), TimeCompare);
+
+  const bool need_sorting =
+      !_points.empty() && points.front().x < _points.xAt(_points.size() - 1);
+  for (const auto& p : points)
+  {
+    _points.push_back(p, this->columnPool());
+  }
+  if (need_sorting)
+  {
+    sort();
+    return;
+  }
+  this->_range_x_dirty = true;
+  this->_generation++;
+  trimRange();
+}
+
 template <typename Value>
 inline int TimeseriesBase<Value>::getIndexFromX(double x) const
 {
@@ -149,19 +308,30 @@ inline int TimeseriesBase<Value>::getIndexFromX(double x) const
   {
     return -1;
   }
-  auto lower = std::lower_bound(_points.begin(), _points.end(), Point(x, {}), TimeCompare);
-  auto index = std::distance(_points.begin(), lower);
+  return closestIndex(_points.lowerBoundX(x), x);
+}
 
-  if (index >= _points.size())
+template <typename Value>
+inline int TimeseriesBase<Value>::getIndexFromX(double x, size_t& cursor) const
+{
+  if (_points.size() == 0)
   {
-    return _points.size() - 1;
+    return -1;
   }
-  if (index < 0)
+  const int index = closestIndex(_points.lowerBoundX(x, cursor), x);
+  cursor = size_t(index);
+  return index;
+}
+
+template <typename Value>
+inline int TimeseriesBase<Value>::closestIndex(size_t index, double x) const
+{
+  if (index >= _points.size())
   {
-    return 0;
+    return _points.size() - 1;
   }
 
-  if (index > 0 && (abs(_points[index - 1].x - x) < abs(_points[index].x - x)))
+  if (index > 0 && (abs(_points.xAt(index - 1) - x) < abs(_points.xAt(index) - x)))
   {
     index = index - 1;
   }
@@ -0,0 +1,36 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "PlotJuggler/chunk_compression.h"
+#include <QCoreApplication>
+#include <QVariant>
+
+Q_DECLARE_OPAQUE_POINTER(PJ::ChunkCompression*)
+Q_DECLARE_METATYPE(PJ::ChunkCompression*)
+Q_GLOBAL_STATIC(PJ::ChunkCompression, _chunk_compression_ptr_from_macro)
+
+namespace PJ
+{
+ChunkCompression* ChunkCompression::instance()
+{
+  // plugins link their own copy of this library: share the instance of the application
+  static ChunkCompression* _ptr = []() -> ChunkCompression* {
+    if (!qApp)
+    {
+      return _chunk_compression_ptr_from_macro;
+    }
+    if (qApp->property("ChunkCompression").isValid())
+    {
+      return qvariant_cast<ChunkCompression*>(qApp->property("ChunkCompression"));
+    }
+    ChunkCompression* ptr = _chunk_compression_ptr_from_macro;
+    qApp->setProperty("ChunkCompression", QVariant::fromValue(ptr));
+    return ptr;
+  }();
+  return _ptr;
+}
+
+}  // namespace PJ
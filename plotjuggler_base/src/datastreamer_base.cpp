@@ -5,12 +5,95 @@
  */
 
 #include "PlotJuggler/datastreamer_base.h"
+#include <type_traits>
 
 namespace PJ
 {
 
+namespace
+{
+// Move the new points of [source] into the series of [batch] with the same name.
+// Attributes, group and maximum range are copied too. Returns true if any point was moved.
+template <typename SeriesMapT>
+bool MoveIngestedSeries(SeriesMapT& source, SeriesMapT& batch_series, PlotDataMapRef& batch)
+{
+  bool moved = false;
+  for (auto it = source.begin(); it != source.end(); it++)
+  {
+    auto& source_plot = it->second;
+    if (source_plot.size() == 0)
+    {
+      continue;
+    }
+    auto batch_it = batch_series.find(source.id(it));
+    if (batch_it == batch_series.end())
+    {
+      batch_it = batch_series
+                     .emplace(std::piecewise_construct, std::forward_as_tuple(it->first),
+                              std::forward_as_tuple(it->first, PlotGroup::Ptr()))
+                     .first;
+    }
+    auto& batch_plot = batch_it->second;
+
+    if (batch_plot.attributes() != source_plot.attributes())
+    {
+      batch_plot.attributes() = source_plot.attributes();
+    }
+    // the batch must not share the groups of the ingest buffer with the main application
+    const auto& source_group = source_plot.group();
+    if (!source_group)
+    {
+      batch_plot.changeGroup({});
+    }
+    else
+    {
+      if (!batch_plot.group() || batch_plot.group()->name() != source_group->name())
+      {
+        batch_plot.changeGroup(batch.getOrCreateGroup(source_group->name()));
+      }
+      if (batch_plot.group()->attributes() != source_group->attributes())
+      {
+        batch_plot.group()->attributes() = source_group->attributes();
+      }
+    }
+
+    using SeriesT = std::decay_t<decltype(source_plot)>;
+    if constexpr (std::is_same_v<PlotData, SeriesT> || std::is_same_v<StringSeries, SeriesT> ||
+                  std::is_same_v<PlotDataAny, SeriesT>)
+    {
+      batch_plot.setMaximumRangeX(source_plot.maximumRangeX());
+    }
+    batch_plot.clonePoints(std::move(source_plot));
+    moved = true;
+  }
+  return moved;
+}
+
+// Remove the points of all the series, that are kept to be reused.
+void ClearPoints(PlotDataMapRef& data)
+{
+  for (auto& it : data.numeric)
+  {
+    it.second.clear();
+  }
+  for (auto& it : data.strings)
+  {
+    it.second.clear();
+  }
+  for (auto& it : data.scatter_xy)
+  {
+    it.second.clear();
+  }
+  for (auto& it : data.user_defined)
+  {
+    it.second.clear();
+  }
+}
+}  // namespace
+
 void PJ::DataStreamer::setMaximumRangeX(double range)
 {
+  _max_range_x = range;
   std::lock_guard<std::mutex> lock(mutex());
   for (auto& it : dataMap().numeric)
   {
@@ -26,6 +109,60 @@ void PJ::DataStreamer::setMaximumRangeX(double range)
   }
 }
 
+bool DataStreamer::publishIngestBuffer()
+{
+  const double max_range_x = _max_range_x;
+  if (max_range_x != _ingest_range_x)
+  {
+    _ingest_range_x = max_range_x;
+    _ingest_buffer.setMaximumRangeX(max_range_x);
+  }
+
+  IngestBatch batch = std::move(_spare_batch);
+  if (!batch && !_recycled_batches.pop(batch))
+  {
+    if (_allocated_batches == INGEST_QUEUE_SIZE)
+    {
+      // all the batches are waiting to be consumed
+      return false;
+    }
+    batch = std::make_unique<PlotDataMapRef>();
+    _allocated_batches++;
+  }
+
+  bool moved = MoveIngestedSeries(_ingest_buffer.numeric, batch->numeric, *batch);
+  moved |= MoveIngestedSeries(_ingest_buffer.strings, batch->strings, *batch);
+  moved |= MoveIngestedSeries(_ingest_buffer.scatter_xy, batch->scatter_xy, *batch);
+  moved |= MoveIngestedSeries(_ingest_buffer.user_defined, batch->user_defined, *batch);
+
+  if (!moved)
+  {
+    _spare_batch = std::move(batch);
+    return false;
+  }
+  // there are never more than INGEST_QUEUE_SIZE batches: this can not fail
+  _published_batches.push(std::move(batch));
+  return true;
+}
+
+void DataStreamer::consumeIngestedData(const std::function<void(PlotDataMapRef&)>& consumer)
+{
+  // bounded, otherwise a fast producer could keep the main application here forever
+  IngestBatch batch;
+  for (size_t i = 0; i < INGEST_QUEUE_SIZE && _published_batches.pop(batch); i++)
+  {
+    consumer(*batch);
+    _recycled_batches.push(std::move(batch));
+  }
+}
+
+void DataStreamer::discardIngestedData()
+{
+  // the queue never contains more than INGEST_QUEUE_SIZE batches: a single call is enough
+  consumeIngestedData([](PlotDataMapRef& batch) { ClearPoints(batch); });
+  ClearPoints(_ingest_buffer);
+}
+
 void DataStreamer::setParserFactories(ParserFactories* parsers)
 {
   _parser_factories = parsers;
@@ -0,0 +1,163 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "PlotJuggler/disk_storage.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QVariant>
+
+Q_DECLARE_OPAQUE_POINTER(PJ::DiskStorage*)
+Q_DECLARE_METATYPE(PJ::DiskStorage*)
+Q_GLOBAL_STATIC(PJ::DiskStorage, _disk_storage_ptr_from_macro)
+
+namespace PJ
+{
+// 64 MB per file
+static constexpr uint32_t SLOTS_PER_SEGMENT = 1024;
+
+struct DiskStorage::Segment
+{
+  QTemporaryFile file;
+  uchar* mapped = nullptr;
+
+  ~Segment()
+  {
+    if (mapped)
+    {
+      file.unmap(mapped);
+    }
+  }
+};
+
+DiskStorage::Slot::~Slot()
+{
+  release();
+}
+
+DiskStorage::Slot::Slot(Slot&& other)
+{
+  *this = std::move(other);
+}
+
+DiskStorage::Slot& DiskStorage::Slot::operator=(Slot&& other)
+{
+  if (this != &other)
+  {
+    release();
+    _owner = other._owner;
+    _data = other._data;
+    _segment = other._segment;
+    _index = other._index;
+    other._owner = nullptr;
+    other._data = nullptr;
+  }
+  return *this;
+}
+
+void DiskStorage::Slot::release()
+{
+  if (_owner && _data)
+  {
+    _owner->release(_segment, _index);
+  }
+  _owner = nullptr;
+  _data = nullptr;
+}
+
+DiskStorage::DiskStorage() : _directory(QDir::tempPath().toStdString())
+{
+}
+
+DiskStorage::~DiskStorage() = default;
+
+DiskStorage* DiskStorage::instance()
+{
+  // plugins link their own copy of this library: share the instance of the application
+  static DiskStorage* _ptr = []() -> DiskStorage* {
+    if (!qApp)
+    {
+      return _disk_storage_ptr_from_macro;
+    }
+    if (qApp->property("DiskStorage").isValid())
+    {
+      return qvariant_cast<DiskStorage*>(qApp->property("DiskStorage"));
+    }
+    DiskStorage* ptr = _disk_storage_ptr_from_macro;
+    qApp->setProperty("DiskStorage", QVariant::fromValue(ptr));
+    return ptr;
+  }();
+  return _ptr;
+}
+
+void DiskStorage::setDirectory(const std::string& path)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _directory = path;
+}
+
+DiskStorage::Slot DiskStorage::allocate()
+{
+  if (!_enabled)
+  {
+    return {};
+  }
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_free_slots.empty() && !addSegment())
+  {
+    return {};
+  }
+  const auto [segment, index] = _free_slots.back();
+  _free_slots.pop_back();
+  _used_slots++;
+
+  Slot slot;
+  slot._owner = this;
+  slot._segment = segment;
+  slot._index = index;
+  slot._data = _segments[segment]->mapped + size_t(index) * SLOT_SIZE;
+  return slot;
+}
+
+size_t DiskStorage::usedBytes() const
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _used_slots * SLOT_SIZE;
+}
+
+void DiskStorage::release(uint32_t segment, uint32_t index)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _free_slots.push_back({ segment, index });
+  _used_slots--;
+}
+
+bool DiskStorage::addSegment()
+{
+  auto segment = std::make_unique<Segment>();
+  QDir dir(QString::fromStdString(_directory));
+  segment->file.setFileTemplate(dir.filePath("plotjuggler_XXXXXX.data"));
+
+  if (!segment->file.open() || !segment->file.resize(qint64(SLOT_SIZE) * SLOTS_PER_SEGMENT))
+  {
+    return false;
+  }
+  segment->mapped = segment->file.map(0, segment->file.size());
+  if (!segment->mapped)
+  {
+    return false;
+  }
+
+  const uint32_t segment_index = static_cast<uint32_t>(_segments.size());
+  for (uint32_t i = SLOTS_PER_SEGMENT; i > 0; i--)
+  {
+    _free_slots.push_back({ segment_index, i - 1 });
+  }
+  _segments.push_back(std::move(segment));
+  return true;
+}
+
+}  // namespace PJ
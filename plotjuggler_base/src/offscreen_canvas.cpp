@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "offscreen_canvas.h"
+#include <set>
+#include <vector>
+#include <QFontDatabase>
+#include <QPainter>
+#include <QTimer>
+#include <QtConcurrent>
+#include "qwt_plot.h"
+#include "qwt_plot_curve.h"
+#include "qwt_plot_marker.h"
+#include "qwt_scale_map.h"
+#include "qwt_symbol.h"
+
+namespace
+{
+// canvases waiting to be rendered. Used only by the GUI thread.
+std::set<OffscreenCanvas*>& scheduledCanvases()
+{
+  static std::set<OffscreenCanvas*> canvases;
+  return canvases;
+}
+
+struct RenderJob
+{
+  OffscreenCanvas* canvas = nullptr;
+  const QwtPlot* plot = nullptr;
+  QwtScaleMap maps[QwtAxis::AxisPositions];
+  QRect contents_rect;
+  QSize size;
+  qreal pixel_ratio = 1.0;
+  QImage image;
+};
+
+// the symbols cache their image in a QPixmap, that can't be used outside the GUI thread
+void disableSymbolCache(const QwtSymbol* symbol)
+{
+  if (symbol && symbol->cachePolicy() != QwtSymbol::NoCache)
+  {
+    const_cast<QwtSymbol*>(symbol)->setCachePolicy(QwtSymbol::NoCache);
+  }
+}
+
+void render(RenderJob& job)
+{
+  job.image = QImage(job.size * job.pixel_ratio, QImage::Format_ARGB32_Premultiplied);
+  job.image.setDevicePixelRatio(job.pixel_ratio);
+  // the background and the border are painted by the canvas
+  job.image.fill(Qt::transparent);
+
+  QPainter painter(&job.image);
+  painter.setClipRect(job.contents_rect);
+  job.plot->drawItems(&painter, job.contents_rect, job.maps);
+}
+}  // namespace
+
+OffscreenCanvas::OffscreenCanvas(QwtPlot* plot) : QwtPlotCanvas(plot)
+{
+  // the frame is already a cache of the items
+  setPaintAttribute(QwtPlotCanvas::BackingStore, false);
+}
+
+OffscreenCanvas::~OffscreenCanvas()
+{
+  scheduledCanvases().erase(this);
+}
+
+QImage OffscreenCanvas::frame() const
+{
+  if (_frame.size() != size() * devicePixelRatioF())
+  {
+    return {};
+  }
+  return _frame;
+}
+
+void OffscreenCanvas::replot()
+{
+  _frame = QImage();
+
+  auto& scheduled = scheduledCanvases();
+  if (scheduled.empty())
+  {
+    QTimer::singleShot(0, &OffscreenCanvas::renderScheduled);
+  }
+  scheduled.insert(this);
+}
+
+void OffscreenCanvas::renderScheduled()
+{
+  std::vector<RenderJob> jobs;
+  for (OffscreenCanvas* canvas : scheduledCanvases())
+  {
+    const QwtPlot* plot = canvas->plot();
+    // a hidden canvas is painted in the usual way, when it is shown
+    if (!plot || !canvas->isVisible())
+    {
+      continue;
+    }
+    RenderJob job;
+    job.canvas = canvas;
+    job.plot = plot;
+    for (int axis = 0; axis < QwtAxis::AxisPositions; axis++)
+    {
+      job.maps[axis] = plot->canvasMap(axis);
+    }
+    job.contents_rect = canvas->contentsRect();
+    job.size = canvas->size();
+    job.pixel_ratio = canvas->devicePixelRatioF();
+
+    for (const QwtPlotItem* item : plot->itemList())
+    {
+      if (auto curve = dynamic_cast<const QwtPlotCurve*>(item))
+      {
+        disableSymbolCache(curve->symbol());
+      }
+      else if (auto marker = dynamic_cast<const QwtPlotMarker*>(item))
+      {
+        disableSymbolCache(marker->symbol());
+      }
+    }
+    jobs.push_back(std::move(job));
+  }
+  scheduledCanvases().clear();
+
+  if (jobs.size() > 1 && QFontDatabase::supportsThreadedFontRendering())
+  {
+    QtConcurrent::blockingMap(jobs, render);
+  }
+  else
+  {
+    for (auto& job : jobs)
+    {
+      render(job);
+    }
+  }
+
+  for (auto& job : jobs)
+  {
+    job.canvas->_frame = std::move(job.image);
+    job.canvas->update(job.canvas->contentsRect());
+  }
+}
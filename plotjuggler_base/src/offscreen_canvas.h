@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OFFSCREEN_CANVAS_H
+#define OFFSCREEN_CANVAS_H
+
+#include <QImage>
+#include "qwt_plot_canvas.h"
+
+/**
+ * @brief Canvas whose items are rendered into an image by a pool of threads.
+ *
+ * replot() doesn't paint: the canvas is scheduled and, when the control returns to the
+ * event loop, all the scheduled canvases are rendered in parallel. The GUI thread only
+ * prepares them (scale maps, size) and then copies the images on the screen, see frame().
+ *
+ * The GUI thread waits for the workers, so that the data are not modified while they
+ * are read.
+ */
+class OffscreenCanvas : public QwtPlotCanvas
+{
+  Q_OBJECT
+
+public:
+  explicit OffscreenCanvas(QwtPlot* plot = nullptr);
+
+  ~OffscreenCanvas() override;
+
+  /// Items of the plot rendered at the last replot, or a null image if they must be
+  /// painted again (the plot changed, or the canvas was resized in the meantime).
+  QImage frame() const;
+
+  /// Render now the scheduled canvases, instead of waiting for the event loop.
+  static void renderScheduled();
+
+public slots:
+  // invoked by name by QwtPlot::replot(), in place of QwtPlotCanvas::replot()
+  void replot();
+
+private:
+  QImage _frame;
+};
+
+#endif  // OFFSCREEN_CANVAS_H
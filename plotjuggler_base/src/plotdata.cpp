@@ -9,8 +9,8 @@
 namespace PJ
 {
 template <typename T>
-typename std::unordered_map<std::string, T>::iterator
-addImpl(std::unordered_map<std::string, T>& series, const std::string& name, PlotGroup::Ptr group)
+typename SeriesMap<T>::iterator addImpl(SeriesMap<T>& series, const std::string& name,
+                                        PlotGroup::Ptr group)
 {
   std::string ID;
   if (group)
@@ -29,14 +29,20 @@ addImpl(std::unordered_map<std::string, T>& series, const std::string& name, Plo
       .first;
 }
 
-template <typename T>
-T& getOrCreateImpl(std::unordered_map<std::string, T>& series, const std::string& name,
-                   const PlotGroup::Ptr& group)
+template <typename T, typename Key>
+T& getOrCreateImpl(SeriesMap<T>& series, const Key& key, const PlotGroup::Ptr& group)
 {
-  auto it = series.find(name);
+  auto it = series.find(key);
   if (it == series.end())
   {
-    it = addImpl(series, name, group);
+    if constexpr (std::is_same_v<Key, SeriesId>)
+    {
+      it = addImpl(series, SeriesNames::instance()->name(key), group);
+    }
+    else
+    {
+      it = addImpl(series, key, group);
+    }
   }
   return it->second;
 }
@@ -77,6 +83,16 @@ StringSeries& PlotDataMapRef::getOrCreateStringSeries(const std::string& name, P
   return getOrCreateImpl(strings, name, group);
 }
 
+PlotData& PlotDataMapRef::getOrCreateNumeric(SeriesId id, PlotGroup::Ptr group)
+{
+  return getOrCreateImpl(numeric, id, group);
+}
+
+StringSeries& PlotDataMapRef::getOrCreateStringSeries(SeriesId id, PlotGroup::Ptr group)
+{
+  return getOrCreateImpl(strings, id, group);
+}
+
 PlotDataAny& PlotDataMapRef::getOrCreateUserDefined(const std::string& name, PlotGroup::Ptr group)
 {
   return getOrCreateImpl(user_defined, name, group);
@@ -10,6 +10,7 @@
 #include "plotmagnifier.h"
 #include "plotzoomer.h"
 #include "plotlegend.h"
+#include "offscreen_canvas.h"
 
 #include "qwt_axis.h"
 #include "qwt_legend.h"
@@ -31,6 +32,7 @@
 #include "qwt_text.h"
 
 #include <array>
+#include <cmath>
 #include <QBoxLayout>
 #include <QMessageBox>
 #include <QSettings>
@@ -135,6 +137,48 @@ public:
     emit parent->widgetResized();
   }
 
+  // Tell the timeseries which interval is painted and on how many pixels, to let them
+  // decimate the samples while they are drawn (see QwtTimeseries::beginDraw).
+  void drawItems(QPainter* painter, const QRectF& canvas_rect,
+                 const QwtScaleMap maps[QwtAxis::AxisPositions]) const override
+  {
+    const QwtScaleMap& x_map = maps[QwtPlot::xBottom];
+    const PJ::Range range_x = { std::min(x_map.s1(), x_map.s2()),
+                                std::max(x_map.s1(), x_map.s2()) };
+    const int width = static_cast<int>(std::ceil(std::abs(x_map.pDist())));
+
+    std::vector<QwtTimeseries*> drawn_series;
+    for (auto& it : curve_list)
+    {
+      if (auto series = dynamic_cast<QwtTimeseries*>(it.curve->data()))
+      {
+        series->beginDraw(range_x, width);
+        drawn_series.push_back(series);
+      }
+    }
+    QwtPlot::drawItems(painter, canvas_rect, maps);
+
+    for (auto series : drawn_series)
+    {
+      series->endDraw();
+    }
+  }
+
+  // the items of an OffscreenCanvas may be rendered already by a worker thread
+  void drawCanvas(QPainter* painter) override
+  {
+    if (auto offscreen = qobject_cast<OffscreenCanvas*>(canvas()))
+    {
+      const QImage frame = offscreen->frame();
+      if (!frame.isNull())
+      {
+        painter->drawImage(QPointF(0, 0), frame);
+        return;
+      }
+    }
+    QwtPlot::drawCanvas(painter);
+  }
+
   std::list<CurveInfo> curve_list;
 
   std::optional<CurveStyle> overridden_curve_style;
@@ -325,9 +369,19 @@ PlotWidgetBase::PlotWidgetBase(QWidget* parent) : _xy_mode(false), _keep_aspect_
 
   QSettings settings;
   bool use_opengl = settings.value("Preferences::use_opengl", true).toBool();
+  bool parallel_rendering = settings.value("Preferences::parallel_rendering", false).toBool();
 
   QWidget* abs_canvas;
-  if (use_opengl)
+  if (parallel_rendering)
+  {
+    auto canvas = new OffscreenCanvas();
+    canvas->setFrameStyle(QFrame::NoFrame);
+    canvas->setFrameStyle(QFrame::Box | QFrame::Plain);
+    canvas->setLineWidth(1);
+    canvas->setPalette(Qt::white);
+    abs_canvas = canvas;
+  }
+  else if (use_opengl)
   {
     auto canvas = new QwtPlotOpenGLCanvas();
     canvas->setFrameStyle(QFrame::NoFrame);
@@ -725,6 +779,11 @@ void PlotWidgetBase::setStyle(QwtPlotCurve* curve, CurveStyle style)
       curve->setCurveAttribute(QwtPlotCurve::Inverted, true);
       break;
   }
+
+  if (auto series = dynamic_cast<QwtTimeseries*>(curve->data()))
+  {
+    series->setDecimationEnabled(style != DOTS && style != LINES_AND_DOTS);
+  }
 }
 
 void PlotWidgetBase::updateCurvesStyle()
@@ -815,6 +874,11 @@ void PlotWidgetBase::replot()
   qwtPlot()->replot();
 }
 
+void PlotWidgetBase::renderScheduledPlots()
+{
+  OffscreenCanvas::renderScheduled();
+}
+
 void PlotWidgetBase::removeAllCurves()
 {
   for (auto& it : curveList())
@@ -0,0 +1,37 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+#include "PlotJuggler/series_map.h"
+#include <QCoreApplication>
+#include <QVariant>
+
+Q_DECLARE_OPAQUE_POINTER(PJ::SeriesNames*)
+Q_DECLARE_METATYPE(PJ::SeriesNames*)
+Q_GLOBAL_STATIC(PJ::SeriesNames, _series_names_ptr_from_macro)
+
+namespace PJ
+{
+SeriesNames* SeriesNames::instance()
+{
+  // the IDs must be the same in the application and in the plugins, that link
+  // their own copy of this library: share the instance of the application
+  static SeriesNames* _ptr = []() -> SeriesNames* {
+    if (!qApp)
+    {
+      return _series_names_ptr_from_macro;
+    }
+    if (qApp->property("SeriesNames").isValid())
+    {
+      return qvariant_cast<SeriesNames*>(qApp->property("SeriesNames"));
+    }
+    SeriesNames* ptr = _series_names_ptr_from_macro;
+    qApp->setProperty("SeriesNames", QVariant::fromValue(ptr));
+    return ptr;
+  }();
+  return _ptr;
+}
+
+}  // namespace PJ
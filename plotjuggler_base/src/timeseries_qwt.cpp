@@ -5,6 +5,7 @@
  */
 
 #include "timeseries_qwt.h"
+#include <algorithm>
 #include <limits>
 #include <stdexcept>
 #include <QMessageBox>
@@ -41,21 +42,7 @@ RangeOpt QwtTimeseries::getVisualizationRangeY(Range range_X)
     return {};
   }
 
-  if (first_index == 0 && last_index == plotData()->size() - 1)
-  {
-    return _ts_data->rangeY();
-  }
-
-  double min_y = (std::numeric_limits<double>::max());
-  double max_y = (std::numeric_limits<double>::lowest());
-
-  for (size_t i = first_index; i < last_index; i++)
-  {
-    const double Y = sample(i).y();
-    min_y = std::min(min_y, Y);
-    max_y = std::max(max_y, Y);
-  }
-  return Range{ min_y, max_y };
+  return _ts_data->rangeYInIndices(first_index, last_index + 1);
 }
 
 std::optional<QPointF> QwtTimeseries::sampleFromTime(double t)
@@ -70,7 +57,7 @@ std::optional<QPointF> QwtTimeseries::sampleFromTime(double t)
 }
 
 TransformedTimeseries::TransformedTimeseries(const PlotData* source_data)
-  : QwtTimeseries(&_dst_data), _dst_data(source_data->plotName(), {}), _src_data(source_data)
+  : QwtTimeseries(source_data), _dst_data(source_data->plotName(), {}), _src_data(source_data)
 {
 }
 
@@ -85,44 +72,51 @@ bool TransformedTimeseries::setTransform(QString transform_ID)
   {
     return true;
   }
-  if (transform_ID.isEmpty())
+  _dst_data.clear();
+  _src_last_time = std::numeric_limits<double>::lowest();
+
+  if (!transform_ID.isEmpty())
+  {
+    _transform = TransformFactory::create(transform_ID.toStdString());
+  }
+  else
   {
     _transform.reset();
-    return false;
   }
 
-  _transform = TransformFactory::create(transform_ID.toStdString());
   if (!_transform)
   {
+    setTimeseries(_src_data);
     return false;
   }
   std::vector<PlotData*> dest = { &_dst_data };
-  _dst_data.clear();
   _transform->setData(nullptr, { _src_data }, dest);
+  setTimeseries(&_dst_data);
   return true;
 }
 
 void TransformedTimeseries::updateCache(bool reset_old_data)
 {
-  if (_transform)
+  // the values may change even if the number of points does not
+  invalidateDecimation();
+
+  if (!_transform)
   {
-    if (reset_old_data)
-    {
-      _dst_data.clear();
-      _transform->reset();
-    }
-    std::vector<PlotData*> dest = { &_dst_data };
-    _transform->calculate();
+    // the source is rendered directly
+    return;
   }
-  else
+
+  const double src_last_time =
+      (_src_data->size() > 0) ? _src_data->back().x : std::numeric_limits<double>::lowest();
+
+  // the source was replaced by older data: the new points can not be appended
+  if (reset_old_data || src_last_time < _src_last_time)
   {
-    // TODO: optimize ??
     _dst_data.clear();
-    for (size_t i = 0; i < _src_data->size(); i++)
-    {
-      _dst_data.pushBack(_src_data->at(i));
-    }
+    _transform->reset();
   }
+  _transform->calculate();
+  _src_last_time = src_last_time;
 }
 
 QString TransformedTimeseries::transformName()
@@ -182,10 +176,149 @@ QPointF QwtSeriesWrapper::sample(size_t i) const
 
 QPointF QwtTimeseries::sample(size_t i) const
 {
+  if (_drawing && _use_decimated)
+  {
+    return _decimated[i];
+  }
   const auto& p = _ts_data->at(i);
   return QPointF(p.x - _time_offset, p.y);
 }
 
+size_t QwtTimeseries::size() const
+{
+  if (_drawing)
+  {
+    // size() is the first method called by QwtPlotCurve::drawSeries, before sample()
+    updateDecimation();
+    if (_use_decimated)
+    {
+      return _decimated.size();
+    }
+  }
+  return QwtSeriesWrapper::size();
+}
+
+void QwtTimeseries::beginDraw(Range range_x, int width_pixels)
+{
+  if (range_x.min != _viewport_x.min || range_x.max != _viewport_x.max ||
+      width_pixels != _viewport_width)
+  {
+    _viewport_x = range_x;
+    _viewport_width = width_pixels;
+    _decimation_dirty = true;
+  }
+  _drawing = true;
+}
+
+void QwtTimeseries::endDraw()
+{
+  _drawing = false;
+}
+
+void QwtTimeseries::setDecimationEnabled(bool enabled)
+{
+  if (enabled != _decimation_enabled)
+  {
+    _decimation_enabled = enabled;
+    _decimation_dirty = true;
+  }
+}
+
+void QwtTimeseries::updateDecimation() const
+{
+  // PointSeriesXY has no timeseries
+  if (!_ts_data)
+  {
+    _use_decimated = false;
+    return;
+  }
+
+  DataSignature signature;
+  signature.size = _ts_data->size();
+  if (signature.size > 0)
+  {
+    signature.front_x = _ts_data->front().x;
+    signature.back_x = _ts_data->back().x;
+  }
+  if (!_decimation_dirty && signature == _decimated_signature)
+  {
+    return;
+  }
+  _decimation_dirty = false;
+  _decimated_signature = signature;
+  _use_decimated = false;
+  _decimated.clear();
+
+  // number of samples per column of pixels below which decimation is not worth it
+  const size_t MIN_SAMPLES_PER_PIXEL = 4;
+
+  const double t_min = _viewport_x.min + _time_offset;
+  const double t_max = _viewport_x.max + _time_offset;
+  if (!_decimation_enabled || _viewport_width <= 0 || signature.size == 0 || t_max <= t_min)
+  {
+    return;
+  }
+
+  const size_t first = _ts_data->lowerBoundIndex(t_min);
+  const size_t last = _ts_data->lowerBoundIndex(t_max);
+  const size_t columns = size_t(_viewport_width);
+
+  if (last - first <= MIN_SAMPLES_PER_PIXEL * columns)
+  {
+    return;
+  }
+
+  auto pushSample = [this](size_t index) {
+    const auto p = _ts_data->at(index);
+    _decimated.emplace_back(p.x - _time_offset, p.y);
+  };
+
+  _decimated.reserve(4 * columns + 2);
+
+  // keep one point on each side of the viewport, to draw the lines crossing its borders
+  if (first > 0)
+  {
+    pushSample(first - 1);
+  }
+
+  const double column_width = (t_max - t_min) / double(columns);
+  size_t begin = first;
+  for (size_t col = 1; col <= columns && begin < last; col++)
+  {
+    size_t end = last;
+    if (col < columns)
+    {
+      end = std::max(begin, _ts_data->lowerBoundIndex(t_min + col * column_width, begin));
+    }
+    if (end - begin <= 4)
+    {
+      for (size_t i = begin; i < end; i++)
+      {
+        pushSample(i);
+      }
+    }
+    else
+    {
+      // the segments first -> min -> max -> last cover the same pixels of the original
+      // polyline, because all these points fall inside the same column.
+      const auto first_point = _ts_data->at(begin);
+      const auto last_point = _ts_data->at(end - 1);
+      const auto range_y = _ts_data->rangeYInIndices(begin, end).value();
+      _decimated.emplace_back(first_point.x - _time_offset, first_point.y);
+      _decimated.emplace_back(first_point.x - _time_offset, range_y.min);
+      _decimated.emplace_back(last_point.x - _time_offset, range_y.max);
+      _decimated.emplace_back(last_point.x - _time_offset, last_point.y);
+    }
+    begin = end;
+  }
+
+  if (last < signature.size)
+  {
+    pushSample(last);
+  }
+  _use_decimated = true;
+}
+
 size_t QwtSeriesWrapper::size() const
 {
   return _data->size();
@@ -193,7 +326,11 @@ size_t QwtSeriesWrapper::size() const
 
 void QwtTimeseries::setTimeOffset(double offset)
 {
-  _time_offset = offset;
+  if (offset != _time_offset)
+  {
+    _time_offset = offset;
+    _decimation_dirty = true;
+  }
 }
 
 RangeOpt QwtSeriesWrapper::getVisualizationRangeX()
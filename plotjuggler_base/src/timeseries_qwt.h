@@ -7,6 +7,7 @@
 #ifndef TIMESERIES_QWT_H
 #define TIMESERIES_QWT_H
 
+#include <limits>
 #include "qwt_series_data.h"
 #include "PlotJuggler/plotdata.h"
 #include "PlotJuggler/transform_function.h"
@@ -39,6 +40,18 @@ public:
   virtual void updateCache(bool reset_old_data)
   {
   }
+
+  /// Changes when the data used by updateCache() changes (see PlotDataBase::generation).
+  virtual uint64_t dataGeneration() const
+  {
+    return plotData()->generation();
+  }
+
+protected:
+  void setPlotData(const PlotDataXY* data)
+  {
+    _data = data;
+  }
 };
 
 class QwtTimeseries : public QwtSeriesWrapper
@@ -50,6 +63,25 @@ public:
 
   QPointF sample(size_t i) const override;
 
+  size_t size() const override;
+
+  /**
+   * @brief Called before drawing the curve, with the visible interval of the X axis
+   * (in plot coordinates) and its width in pixels.
+   *
+   * Until endDraw(), when the visible interval contains many more samples than pixels,
+   * size() and sample() return a decimated series that keeps, for each column of pixels,
+   * the first, last, minimum and maximum value (M4 aggregation). The rendered image is
+   * the same, but the cost of painting depends on the width of the canvas, not on the
+   * length of the series. Outside of drawing, they always return the original samples.
+   */
+  void beginDraw(Range range_x, int width_pixels);
+
+  void endDraw();
+
+  // Decimation is not appropriate when each sample is drawn as a dot.
+  void setDecimationEnabled(bool enabled);
+
   QRectF boundingRect() const override;
 
   void setTimeOffset(double offset);
@@ -67,10 +99,54 @@ public:
 protected:
   const PlotData* _ts_data;
   double _time_offset = 0.0;
+
+  void invalidateDecimation()
+  {
+    _decimation_dirty = true;
+  }
+
+  /// Change the series that is rendered.
+  void setTimeseries(const PlotData* data)
+  {
+    setPlotData(data);
+    _ts_data = data;
+    invalidateDecimation();
+  }
+
+private:
+  void updateDecimation() const;
+
+  struct DataSignature
+  {
+    size_t size = 0;
+    double front_x = 0;
+    double back_x = 0;
+    bool operator==(const DataSignature& other) const
+    {
+      return size == other.size && front_x == other.front_x && back_x == other.back_x;
+    }
+  };
+
+  bool _decimation_enabled = true;
+  bool _drawing = false;
+  Range _viewport_x = { 0, 0 };
+  int _viewport_width = 0;
+
+  mutable bool _decimation_dirty = true;
+  mutable DataSignature _decimated_signature;
+  mutable bool _use_decimated = false;
+  mutable std::vector<QPointF> _decimated;
 };
 
 //------------------------------------
 
+/**
+ * @brief Series that is the result of a transform of another one.
+ *
+ * Without a transform, the source series is rendered directly, without any copy.
+ * Otherwise the result is stored in _dst_data and updated incrementally: only the
+ * points of the source that arrived since the previous update are transformed.
+ */
 class TransformedTimeseries : public QwtTimeseries
 {
 public:
@@ -83,6 +159,11 @@ public:
 
   virtual void updateCache(bool reset_old_data) override;
 
+  uint64_t dataGeneration() const override
+  {
+    return _src_data->generation();
+  }
+
   QString transformName();
 
   QString alias() const;
@@ -94,6 +175,8 @@ protected:
   PlotData _dst_data;
   const PlotData* _src_data;
   TransformFunction_SISO::Ptr _transform;
+  // time of the last point of the source, at the previous update
+  double _src_last_time = std::numeric_limits<double>::lowest();
 };
 
 //---------------------------------------------------------
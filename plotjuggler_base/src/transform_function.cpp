@@ -50,28 +50,22 @@ void TransformFunction_SISO::calculate()
     return;
   }
   dst_data->setMaximumRangeX(src_data->maximumRangeX());
-  if (dst_data->size() != 0)
+
+  // only the points after the last one that was already processed
+  size_t index = src_data->lowerBoundIndex(_last_timestamp);
+  while (index < src_data->size() && src_data->at(index).x <= _last_timestamp)
   {
-    _last_timestamp = dst_data->back().x;
+    index++;
   }
 
-  int pos = src_data->getIndexFromX(_last_timestamp);
-  size_t index = pos < 0 ? 0 : static_cast<size_t>(pos);
-
-  while (index < src_data->size())
+  for (; index < src_data->size(); index++)
   {
-    const auto& in_point = src_data->at(index);
-
-    if (in_point.x >= _last_timestamp)
+    auto out_point = calculateNextPoint(index);
+    if (out_point)
     {
-      auto out_point = calculateNextPoint(index);
-      if (out_point)
-      {
-        dst_data->pushBack(std::move(out_point.value()));
-      }
-      _last_timestamp = in_point.x;
+      dst_data->pushBack(std::move(out_point.value()));
     }
-    index++;
+    _last_timestamp = src_data->at(index).x;
   }
 }
 
@@ -0,0 +1,280 @@
+#include "PlotJuggler/chunk_compression.h"
+#include "PlotJuggler/chunked_columns.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace PJ;
+
+namespace
+{
+// the codec is lossless: compare the bit patterns, to check also NaN and -0.0
+bool sameBits(double a, double b)
+{
+  return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+void expectRoundTrip(const std::vector<double>& x, const std::vector<double>& y)
+{
+  ASSERT_EQ(x.size(), y.size());
+  std::vector<uint64_t> compressed;
+  ChunkCompression::Compress(x.data(), y.data(), x.size(), compressed);
+
+  std::vector<double> out_x(x.size());
+  std::vector<double> out_y(y.size());
+  ChunkCompression::Decompress(compressed, x.size(), out_x.data(), out_y.data());
+  for (size_t i = 0; i < x.size(); i++)
+  {
+    ASSERT_TRUE(sameBits(out_x[i], x[i])) << "x at index " << i;
+    ASSERT_TRUE(sameBits(out_y[i], y[i])) << "y at index " << i;
+  }
+}
+
+struct Point
+{
+  double x = 0;
+  double y = 0;
+  Point(double x_, double y_) : x(x_), y(y_)
+  {
+  }
+  Point() = default;
+};
+
+// enable the compression in the scope of a test
+class CompressionEnabled
+{
+public:
+  CompressionEnabled()
+  {
+    ChunkCompression::instance()->setEnabled(true);
+  }
+  ~CompressionEnabled()
+  {
+    ChunkCompression::instance()->setEnabled(false);
+  }
+};
+}  // namespace
+
+// ===========================================================================
+// Codec
+// ===========================================================================
+
+TEST(ChunkCompression, RegularSampling)
+{
+  std::vector<double> x, y;
+  for (int i = 0; i < 4096; i++)
+  {
+    x.push_back(1700000000.0 + i * 0.01);
+    y.push_back(std::sin(i * 0.01));
+  }
+  expectRoundTrip(x, y);
+}
+
+TEST(ChunkCompression, ConstantValuesAreSmall)
+{
+  std::vector<double> x, y;
+  for (int i = 0; i < 4096; i++)
+  {
+    x.push_back(double(i));
+    y.push_back(42.0);
+  }
+  expectRoundTrip(x, y);
+
+  std::vector<uint64_t> compressed;
+  ChunkCompression::Compress(x.data(), y.data(), x.size(), compressed);
+  // about 2 bits per sample, against 128 of the raw data
+  EXPECT_LT(compressed.size() * 64, x.size() * 4);
+}
+
+TEST(ChunkCompression, IrregularSampling)
+{
+  std::mt19937 rng(1);
+  std::exponential_distribution<double> step(100.0);
+  std::normal_distribution<double> value(0.0, 1e6);
+  std::vector<double> x, y;
+  double t = -50.0;
+  for (int i = 0; i < 4096; i++)
+  {
+    t += (i % 10 == 0) ? 0.0 : step(rng);
+    x.push_back(t);
+    y.push_back(value(rng));
+  }
+  expectRoundTrip(x, y);
+}
+
+TEST(ChunkCompression, SpecialValues)
+{
+  const double inf = std::numeric_limits<double>::infinity();
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double denorm = std::numeric_limits<double>::denorm_min();
+  const double max = std::numeric_limits<double>::max();
+
+  std::vector<double> y = { 0.0, -0.0, inf, -inf, nan, denorm, -denorm, max, -max, 1.0, 1.0 };
+  std::vector<double> x = { 0.0, 1e-300, 1.0, 1e300, -1e300, 5.0, 5.0, 5.0, 6.0, 0.0, max };
+  expectRoundTrip(x, y);
+}
+
+TEST(ChunkCompression, FewSamples)
+{
+  expectRoundTrip({ 3.5 }, { -2.0 });
+  expectRoundTrip({ 3.5, 4.5 }, { -2.0, 7.0 });
+  expectRoundTrip({}, {});
+}
+
+// ===========================================================================
+// Compressed chunks of ChunkedColumns
+// ===========================================================================
+
+TEST(ChunkCompression, CompressedChunksReadBack)
+{
+  using Columns = ChunkedColumns<double, double, Point>;
+  const size_t count = 5 * Columns::CHUNK_SIZE + 17;
+
+  Columns columns;
+  {
+    CompressionEnabled enabled;
+    for (size_t i = 0; i < count; i++)
+    {
+      columns.push_back({ i * 0.001, std::cos(i * 0.1) });
+    }
+  }
+
+  // random access, that alternates between the chunks
+  for (size_t i = 0; i < Columns::CHUNK_SIZE; i += 61)
+  {
+    for (size_t chunk = 0; chunk < 5; chunk++)
+    {
+      const size_t index = chunk * Columns::CHUNK_SIZE + i;
+      ASSERT_EQ(columns.xAt(index), index * 0.001);
+      ASSERT_EQ(columns.yAt(index), std::cos(index * 0.1));
+    }
+  }
+  EXPECT_EQ(columns.lowerBoundX(2.0005), 2001u);
+
+  // modifying a compressed chunk unpacks it
+  columns.set(10, { 10 * 0.001, 5.0 });
+  EXPECT_EQ(columns.yAt(10), 5.0);
+  EXPECT_EQ(columns.yAt(11), std::cos(1.1));
+  EXPECT_EQ(columns.rangeY(0, count)->max, 5.0);
+}
+
+TEST(ChunkCompression, BoundXOnCompressedChunks)
+{
+  using Columns = ChunkedColumns<double, double, Point>;
+  const size_t count = 6 * Columns::CHUNK_SIZE + 100;
+
+  // x has long runs of duplicates, that cross the boundaries of the chunks
+  std::vector<double> xs;
+  Columns columns;
+  {
+    CompressionEnabled enabled;
+    for (size_t i = 0; i < count; i++)
+    {
+      const double x = double(i / 1000);
+      xs.push_back(x);
+      columns.push_back({ x, double(i) });
+    }
+  }
+  const size_t popped = Columns::CHUNK_SIZE + 300;
+  columns.pop_front(popped);
+  xs.erase(xs.begin(), xs.begin() + popped);
+
+  for (double x = -1.0; x < double(count / 1000) + 2; x += 0.5)
+  {
+    const size_t lower = size_t(std::lower_bound(xs.begin(), xs.end(), x) - xs.begin());
+    const size_t upper = size_t(std::upper_bound(xs.begin(), xs.end(), x) - xs.begin());
+    ASSERT_EQ(columns.lowerBoundX(x), lower) << "x " << x;
+    ASSERT_EQ(columns.upperBoundX(x), upper) << "x " << x;
+    for (size_t hint : { size_t(0), lower, xs.size() / 2, xs.size() - 1 })
+    {
+      ASSERT_EQ(columns.lowerBoundX(x, hint), lower) << "x " << x << " hint " << hint;
+      ASSERT_EQ(columns.upperBoundX(x, hint), upper) << "x " << x << " hint " << hint;
+    }
+  }
+  EXPECT_EQ(columns.xAt(0), xs.front());
+  EXPECT_EQ(columns.xAt(xs.size() - 1), xs.back());
+}
+
+TEST(ChunkCompression, CopiesOfModifiedChunks)
+{
+  using Columns = ChunkedColumns<double, double, Point>;
+  const size_t count = 3 * Columns::CHUNK_SIZE;
+
+  Columns columns;
+  {
+    CompressionEnabled enabled;
+    for (size_t i = 0; i < count; i++)
+    {
+      columns.push_back({ double(i), double(i) });
+    }
+  }
+  const Columns copy = columns;
+  // the copy shares the unpacked chunk of the original, until it is modified
+  EXPECT_EQ(copy.yAt(10), 10.0);
+  EXPECT_EQ(columns.yAt(10), 10.0);
+  columns.set(10, { 10.0, -1.0 });
+  EXPECT_EQ(columns.yAt(10), -1.0);
+  EXPECT_EQ(copy.yAt(10), 10.0);
+  EXPECT_EQ(copy.yAt(11), 11.0);
+}
+
+TEST(ChunkCompression, ConcurrentReads)
+{
+  using Columns = ChunkedColumns<double, double, Point>;
+  const size_t chunks = 8;
+  const size_t count = chunks * Columns::CHUNK_SIZE + 5;
+
+  Columns columns;
+  {
+    CompressionEnabled enabled;
+    for (size_t i = 0; i < count; i++)
+    {
+      columns.push_back({ double(i), std::sin(i * 0.01) });
+    }
+  }
+
+  // each thread reads the chunks in a different order, evicting the unpacked ones
+  std::vector<std::thread> threads;
+  std::vector<int> errors(4, 0);
+  for (size_t t = 0; t < errors.size(); t++)
+  {
+    threads.emplace_back([&columns, &errors, t, count]() {
+      for (size_t i = 0; i < Columns::CHUNK_SIZE; i += 97)
+      {
+        for (size_t c = 0; c < chunks; c++)
+        {
+          const size_t index = ((c * (t + 1)) % chunks) * Columns::CHUNK_SIZE + i;
+          const Point p = columns[index];
+          if (p.x != double(index) || p.y != std::sin(index * 0.01))
+          {
+            errors[t]++;
+          }
+        }
+      }
+      double sum_x = 0;
+      columns.forEachSpan(0, count, [&](const double* x, const double*, size_t n) {
+        for (size_t i = 0; i < n; i++)
+        {
+          sum_x += x[i];
+        }
+      });
+      if (sum_x != double(count) * double(count - 1) / 2)
+      {
+        errors[t]++;
+      }
+    });
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  for (size_t t = 0; t < errors.size(); t++)
+  {
+    EXPECT_EQ(errors[t], 0) << "thread " << t;
+  }
+}
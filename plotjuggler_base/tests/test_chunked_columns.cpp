@@ -0,0 +1,434 @@
+#include "PlotJuggler/chunked_columns.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace PJ;
+
+namespace
+{
+struct Point
+{
+  double x = 0;
+  double y = 0;
+  Point(double x_, double y_) : x(x_), y(y_)
+  {
+  }
+  Point() = default;
+};
+
+using Columns = ChunkedColumns<double, double, Point>;
+
+constexpr size_t CHUNK = Columns::CHUNK_SIZE;
+
+// y is a deterministic function of the index, with many local minima and maxima
+double valueAt(size_t i)
+{
+  return double((i * 7919) % 1000) - 500.0;
+}
+
+Columns makeColumns(size_t count, size_t first = 0)
+{
+  Columns columns;
+  for (size_t i = first; i < first + count; i++)
+  {
+    columns.push_back({ double(i), valueAt(i) });
+  }
+  return columns;
+}
+
+void expectSequence(const Columns& columns, size_t first, size_t count)
+{
+  ASSERT_EQ(columns.size(), count);
+  for (size_t i = 0; i < count; i++)
+  {
+    ASSERT_EQ(columns.xAt(i), double(first + i)) << "index " << i;
+    ASSERT_EQ(columns.yAt(i), valueAt(first + i)) << "index " << i;
+  }
+}
+
+Columns::MinMax bruteForceRange(const Columns& columns, size_t first, size_t last)
+{
+  Columns::MinMax range = { columns.yAt(first), columns.yAt(first) };
+  for (size_t i = first + 1; i < last; i++)
+  {
+    range.min = std::min(range.min, columns.yAt(i));
+    range.max = std::max(range.max, columns.yAt(i));
+  }
+  return range;
+}
+}  // namespace
+
+// ===========================================================================
+// Append and read
+// ===========================================================================
+
+TEST(ChunkedColumns, Empty)
+{
+  Columns columns;
+  EXPECT_TRUE(columns.empty());
+  EXPECT_EQ(columns.size(), 0u);
+  EXPECT_EQ(columns.begin(), columns.end());
+  EXPECT_EQ(columns.lowerBoundX(1.0), 0u);
+  EXPECT_FALSE(columns.rangeY(0, 0).has_value());
+}
+
+TEST(ChunkedColumns, PushBackAcrossChunks)
+{
+  const size_t count = 3 * CHUNK + 10;
+  Columns columns = makeColumns(count);
+  expectSequence(columns, 0, count);
+
+  EXPECT_EQ(columns.front().x, 0.0);
+  EXPECT_EQ(columns.back().x, double(count - 1));
+
+  size_t index = 0;
+  for (const auto& p : columns)
+  {
+    ASSERT_EQ(p.x, double(index));
+    index++;
+  }
+  EXPECT_EQ(index, count);
+}
+
+TEST(ChunkedColumns, AppendEqualsPushBack)
+{
+  const size_t count = 2 * CHUNK + 100;
+  std::vector<double> x, y;
+  for (size_t i = 0; i < count; i++)
+  {
+    x.push_back(double(i));
+    y.push_back(valueAt(i));
+  }
+  Columns columns;
+  // unaligned batches, to cross the boundaries of chunks and blocks
+  size_t pos = 0;
+  for (size_t batch : { size_t(1), size_t(63), CHUNK - 10, size_t(700), count })
+  {
+    batch = std::min(batch, count - pos);
+    columns.append(x.data() + pos, y.data() + pos, batch);
+    pos += batch;
+  }
+  expectSequence(columns, 0, count);
+
+  const auto range = columns.rangeY(0, count);
+  ASSERT_TRUE(range.has_value());
+  EXPECT_EQ(range->min, -500.0);
+  EXPECT_EQ(range->max, 499.0);
+}
+
+TEST(ChunkedColumns, ForEachSpan)
+{
+  const size_t count = 2 * CHUNK + 50;
+  Columns columns = makeColumns(count);
+
+  size_t visited = 0;
+  size_t spans = 0;
+  columns.forEachSpan(10, count - 10, [&](const double* x, const double* y, size_t n) {
+    for (size_t i = 0; i < n; i++)
+    {
+      EXPECT_EQ(x[i], double(10 + visited + i));
+      EXPECT_EQ(y[i], valueAt(10 + visited + i));
+    }
+    visited += n;
+    spans++;
+  });
+  EXPECT_EQ(visited, count - 20);
+  EXPECT_EQ(spans, 3u);
+}
+
+TEST(ChunkedColumns, CopyAndMove)
+{
+  const size_t count = CHUNK + 10;
+  Columns columns = makeColumns(count);
+
+  Columns copy = columns;
+  expectSequence(copy, 0, count);
+  expectSequence(columns, 0, count);
+
+  Columns moved = std::move(copy);
+  expectSequence(moved, 0, count);
+  EXPECT_TRUE(copy.empty());
+}
+
+// ===========================================================================
+// pop_front
+// ===========================================================================
+
+TEST(ChunkedColumns, PopFrontOne)
+{
+  Columns columns = makeColumns(CHUNK + 3);
+  for (size_t i = 0; i < CHUNK + 1; i++)
+  {
+    columns.pop_front();
+  }
+  expectSequence(columns, CHUNK + 1, 2);
+
+  columns.pop_front();
+  columns.pop_front();
+  EXPECT_TRUE(columns.empty());
+
+  // the container is reusable after becoming empty
+  columns.push_back({ 1, 2 });
+  EXPECT_EQ(columns.size(), 1u);
+  EXPECT_EQ(columns.yAt(0), 2.0);
+}
+
+TEST(ChunkedColumns, PopFrontCount)
+{
+  const size_t count = 4 * CHUNK;
+  Columns columns = makeColumns(count);
+
+  columns.pop_front(100);
+  expectSequence(columns, 100, count - 100);
+
+  columns.pop_front(2 * CHUNK);
+  expectSequence(columns, 2 * CHUNK + 100, count - 2 * CHUNK - 100);
+
+  // the range must not include the removed values
+  const auto range = columns.rangeY(0, columns.size());
+  const auto expected = bruteForceRange(columns, 0, columns.size());
+  EXPECT_EQ(range->min, expected.min);
+  EXPECT_EQ(range->max, expected.max);
+
+  columns.pop_front(count);
+  EXPECT_TRUE(columns.empty());
+}
+
+// ===========================================================================
+// splice
+// ===========================================================================
+
+TEST(ChunkedColumns, SpliceUnaligned)
+{
+  Columns columns = makeColumns(CHUNK + 10);
+  Columns other = makeColumns(2 * CHUNK, CHUNK + 10);
+
+  columns.splice(std::move(other));
+  EXPECT_TRUE(other.empty());
+  expectSequence(columns, 0, 3 * CHUNK + 10);
+}
+
+TEST(ChunkedColumns, SpliceAligned)
+{
+  // both start at the beginning of a chunk: the chunks of other are moved
+  Columns columns = makeColumns(2 * CHUNK);
+  Columns other = makeColumns(3 * CHUNK + 7, 2 * CHUNK);
+
+  columns.splice(std::move(other));
+  EXPECT_TRUE(other.empty());
+  expectSequence(columns, 0, 5 * CHUNK + 7);
+
+  const auto range = columns.rangeY(CHUNK + 3, columns.size());
+  const auto expected = bruteForceRange(columns, CHUNK + 3, columns.size());
+  EXPECT_EQ(range->min, expected.min);
+  EXPECT_EQ(range->max, expected.max);
+}
+
+TEST(ChunkedColumns, SpliceAfterPopFront)
+{
+  // other starts in the middle of its first chunk, at the same offset of the end of columns
+  Columns columns = makeColumns(CHUNK + 100);
+  Columns other = makeColumns(3 * CHUNK + 100, CHUNK);
+  other.pop_front(100);
+
+  columns.splice(std::move(other));
+  expectSequence(columns, 0, 4 * CHUNK + 100);
+}
+
+TEST(ChunkedColumns, SpliceIntoEmpty)
+{
+  Columns columns;
+  Columns other = makeColumns(CHUNK + 1);
+  columns.splice(std::move(other));
+  expectSequence(columns, 0, CHUNK + 1);
+}
+
+// ===========================================================================
+// set and insert
+// ===========================================================================
+
+TEST(ChunkedColumns, SetUpdatesRange)
+{
+  Columns columns = makeColumns(2 * CHUNK);
+
+  columns.set(CHUNK + 5, { double(CHUNK + 5), 1000.0 });
+  EXPECT_EQ(columns.yAt(CHUNK + 5), 1000.0);
+  EXPECT_EQ(columns.rangeY(0, columns.size())->max, 1000.0);
+  EXPECT_EQ(columns.rangeY(CHUNK, CHUNK + 64)->max, 1000.0);
+  EXPECT_EQ(columns.rangeY(0, CHUNK)->max, 499.0);
+
+  columns.set(CHUNK + 5, { double(CHUNK + 5), -1000.0 });
+  EXPECT_EQ(columns.rangeY(0, columns.size())->max, 499.0);
+  EXPECT_EQ(columns.rangeY(0, columns.size())->min, -1000.0);
+}
+
+TEST(ChunkedColumns, SetThenStream)
+{
+  Columns columns = makeColumns(4 * CHUNK);
+
+  // a sealed chunk gets the maximum and then loses it, while the series keeps growing
+  columns.set(CHUNK + 5, { double(CHUNK + 5), 1000.0 });
+  columns.set(2 * CHUNK + 5, { double(2 * CHUNK + 5), -1000.0 });
+  EXPECT_EQ(columns.rangeY(CHUNK, columns.size())->max, 1000.0);
+  EXPECT_EQ(columns.rangeY(2 * CHUNK, columns.size())->min, -1000.0);
+
+  for (size_t i = 4 * CHUNK; i < 5 * CHUNK + 10; i++)
+  {
+    columns.push_back({ double(i), valueAt(i) });
+  }
+  EXPECT_EQ(columns.rangeY(CHUNK, columns.size())->max, 1000.0);
+  EXPECT_EQ(columns.rangeY(3 * CHUNK, columns.size())->min, -500.0);
+
+  columns.set(CHUNK + 5, { double(CHUNK + 5), 0.0 });
+  columns.pop_front(2 * CHUNK);
+  auto expected = bruteForceRange(columns, 0, columns.size());
+  EXPECT_EQ(columns.rangeY(0, columns.size())->min, expected.min);
+  EXPECT_EQ(columns.rangeY(0, columns.size())->max, expected.max);
+
+  columns.push_back({ double(6 * CHUNK), 2000.0 });
+  EXPECT_EQ(columns.rangeY(0, columns.size())->max, 2000.0);
+  EXPECT_EQ(columns.rangeY(0, columns.size())->min, -1000.0);
+}
+
+TEST(ChunkedColumns, InsertShiftsElements)
+{
+  const size_t count = 2 * CHUNK + 10;
+  Columns columns = makeColumns(count);
+
+  columns.insert(CHUNK - 1, { CHUNK - 1.5, 2000.0 });
+  ASSERT_EQ(columns.size(), count + 1);
+  EXPECT_EQ(columns.xAt(CHUNK - 2), double(CHUNK - 2));
+  EXPECT_EQ(columns.xAt(CHUNK - 1), CHUNK - 1.5);
+  EXPECT_EQ(columns.yAt(CHUNK - 1), 2000.0);
+  for (size_t i = CHUNK; i < columns.size(); i++)
+  {
+    ASSERT_EQ(columns.xAt(i), double(i - 1));
+    ASSERT_EQ(columns.yAt(i), valueAt(i - 1));
+  }
+  EXPECT_EQ(columns.rangeY(0, columns.size())->max, 2000.0);
+
+  // at the end, insert is the same as push_back
+  columns.insert(columns.size(), { 1e6, 0.0 });
+  EXPECT_EQ(columns.back().x, 1e6);
+}
+
+// ===========================================================================
+// rangeY and boundX
+// ===========================================================================
+
+TEST(ChunkedColumns, RangeYMatchesBruteForce)
+{
+  const size_t count = 5 * CHUNK + 123;
+  Columns columns = makeColumns(count);
+  columns.pop_front(77);
+
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<size_t> dist(0, columns.size() - 1);
+  for (int i = 0; i < 500; i++)
+  {
+    size_t first = dist(rng);
+    size_t last = dist(rng);
+    if (first > last)
+    {
+      std::swap(first, last);
+    }
+    last++;
+    // the intervals that end with the last element use the monotonic queues
+    if (i % 5 == 0)
+    {
+      last = columns.size();
+    }
+    const auto range = columns.rangeY(first, last);
+    const auto expected = bruteForceRange(columns, first, last);
+    ASSERT_TRUE(range.has_value());
+    ASSERT_EQ(range->min, expected.min) << first << " " << last;
+    ASSERT_EQ(range->max, expected.max) << first << " " << last;
+  }
+}
+
+TEST(ChunkedColumns, RangeYWhileStreaming)
+{
+  // a sliding window, as in a streaming buffer
+  Columns columns;
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> value(-1.0, 1.0);
+  for (size_t i = 0; i < 20 * CHUNK; i++)
+  {
+    columns.push_back({ double(i), value(rng) * double(i % 3000) });
+    if (columns.size() > 3 * CHUNK)
+    {
+      columns.pop_front(columns.size() - 3 * CHUNK);
+    }
+    if (i % 1000 == 0)
+    {
+      const auto range = columns.rangeY(0, columns.size());
+      const auto expected = bruteForceRange(columns, 0, columns.size());
+      ASSERT_EQ(range->min, expected.min);
+      ASSERT_EQ(range->max, expected.max);
+    }
+  }
+}
+
+TEST(ChunkedColumns, BoundXMatchesStdAlgorithms)
+{
+  // irregular timestamps with duplicates
+  Columns columns;
+  std::vector<double> reference;
+  double t = 0;
+  std::mt19937 rng(3);
+  std::exponential_distribution<double> step(10.0);
+  for (size_t i = 0; i < 3 * CHUNK; i++)
+  {
+    if (i % 17 != 0)
+    {
+      t += step(rng);
+    }
+    columns.push_back({ t, 0.0 });
+    reference.push_back(t);
+  }
+
+  std::uniform_real_distribution<double> query(-1.0, t + 1.0);
+  std::uniform_int_distribution<size_t> hint(0, 2 * columns.size());
+  for (int i = 0; i < 2000; i++)
+  {
+    // half of the queries are exact values
+    const double x = (i % 2) ? query(rng) : reference[hint(rng) % reference.size()];
+    const size_t lower = std::lower_bound(reference.begin(), reference.end(), x) -
+                         reference.begin();
+    const size_t upper = std::upper_bound(reference.begin(), reference.end(), x) -
+                         reference.begin();
+    ASSERT_EQ(columns.lowerBoundX(x), lower) << x;
+    ASSERT_EQ(columns.upperBoundX(x), upper) << x;
+    ASSERT_EQ(columns.lowerBoundX(x, hint(rng)), lower) << x;
+  }
+}
+
+// ===========================================================================
+// Narrowed chunks
+// ===========================================================================
+
+TEST(ChunkedColumns, NarrowedChunksReadBack)
+{
+  Columns columns;
+  columns.setValueType(BuiltinType::FLOAT32);
+  const size_t count = 4 * CHUNK + 3;
+  for (size_t i = 0; i < count; i++)
+  {
+    // the third chunk contains a value that is not a float: it stays in doubles
+    const double y = (i == 2 * CHUNK + 1) ? 0.1 : valueAt(i) * 0.25;
+    columns.push_back({ double(i), y });
+  }
+
+  // lookups by X alternate between chunks, with and without reading Y
+  for (size_t i = 0; i < count; i += 97)
+  {
+    ASSERT_EQ(columns.lowerBoundX(double(i) - 0.5), i);
+    ASSERT_EQ(columns.xAt(count - 1 - i), double(count - 1 - i));
+    const double expected = (i == 2 * CHUNK + 1) ? 0.1 : valueAt(i) * 0.25;
+    ASSERT_EQ(columns.yAt(i), expected);
+  }
+  EXPECT_EQ(columns.yAt(2 * CHUNK + 1), 0.1);
+  EXPECT_EQ(columns.rangeY(0, count)->max, 499.0 * 0.25);
+}
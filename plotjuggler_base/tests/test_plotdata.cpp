@@ -0,0 +1,83 @@
+#include "PlotJuggler/plotdata.h"
+#include <gtest/gtest.h>
+#include <utility>
+
+using namespace PJ;
+
+namespace
+{
+PlotData makeSeries(size_t count)
+{
+  PlotData data("series", {});
+  for (size_t i = 0; i < count; i++)
+  {
+    data.pushBack({ double(i), double(i) * 10.0 });
+  }
+  return data;
+}
+}  // namespace
+
+// ===========================================================================
+// Mutable accessors (references to points stored in columns)
+// ===========================================================================
+
+TEST(PlotData, AssignThroughReference)
+{
+  PlotData data = makeSeries(100);
+  const uint64_t generation = data.generation();
+
+  auto& p = data.at(5);
+  p = { 5.0, -1.0 };
+  EXPECT_EQ(std::as_const(data).at(5).y, -1.0);
+  EXPECT_GT(data.generation(), generation);
+
+  data[6].y = 42.0;
+  EXPECT_EQ(data[6].x, 6.0);
+  EXPECT_EQ(data[6].y, 42.0);
+
+  data[7].y = data[6].y;
+  EXPECT_EQ(data.at(7).y, 42.0);
+
+  EXPECT_EQ(data.rangeY()->min, -1.0);
+}
+
+TEST(PlotData, ReferenceReadsCurrentValue)
+{
+  PlotData data = makeSeries(10);
+  auto& p = data.at(3);
+  data.setPoint(3, { 3.0, 7.0 });
+  EXPECT_EQ(double(p.y), 7.0);
+
+  PlotData::Point copy = p;
+  data.setPoint(3, { 3.0, 8.0 });
+  EXPECT_EQ(copy.y, 7.0);
+}
+
+TEST(PlotData, MutableIteration)
+{
+  PlotData data = makeSeries(5000);
+  for (auto& p : data)
+  {
+    p.y = p.x * 2.0;
+  }
+  const PlotData& const_data = data;
+  size_t index = 0;
+  for (auto& p : const_data)
+  {
+    ASSERT_EQ(p.y, double(index) * 2.0);
+    index++;
+  }
+  EXPECT_EQ(index, data.size());
+
+  PlotData::ConstIterator it = data.begin() + 10;
+  EXPECT_EQ(it->x, 10.0);
+}
+
+TEST(PlotData, PushBackUnsortedPoint)
+{
+  PlotData data = makeSeries(10);
+  data.pushBack({ 4.5, -5.0 });
+  ASSERT_EQ(data.size(), 11u);
+  EXPECT_EQ(data.at(5).x, 4.5);
+  EXPECT_EQ(data.at(6).x, 5.0);
+}
@@ -0,0 +1,192 @@
+#include "PlotJuggler/series_map.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <tuple>
+
+using namespace PJ;
+
+namespace
+{
+using Map = SeriesMap<int>;
+
+Map::iterator add(Map& map, const std::string& name, int value)
+{
+  return map.emplace(std::piecewise_construct, std::forward_as_tuple(name),
+                     std::forward_as_tuple(value))
+      .first;
+}
+}  // namespace
+
+// ===========================================================================
+// Lookup
+// ===========================================================================
+
+TEST(SeriesMap, EmplaceAndFind)
+{
+  Map map;
+  const int* a = &add(map, "map/a", 1)->second;
+  add(map, "map/b", 2);
+  EXPECT_EQ(map.size(), 2u);
+
+  auto [it, inserted] = map.emplace(std::piecewise_construct, std::forward_as_tuple("map/a"),
+                                    std::forward_as_tuple(3));
+  EXPECT_FALSE(inserted);
+  EXPECT_EQ(&it->second, a);
+  EXPECT_EQ(it->second, 1);
+
+  EXPECT_EQ(map.find("map/b")->second, 2);
+  EXPECT_EQ(map.count("map/b"), 1u);
+  EXPECT_EQ(map.find("map/missing"), map.end());
+  EXPECT_EQ(map.count("map/missing"), 0u);
+
+  const SeriesId id = map.id(map.find("map/b"));
+  EXPECT_EQ(id, SeriesNames::instance()->find("map/b"));
+  EXPECT_EQ(SeriesNames::instance()->name(id), "map/b");
+  EXPECT_EQ(map.find(id)->first, "map/b");
+}
+
+TEST(SeriesMap, SameIdInEveryMap)
+{
+  Map first;
+  Map second;
+  add(first, "shared/x", 1);
+  add(second, "shared/y", 2);
+  add(second, "shared/x", 3);
+
+  const SeriesId id = first.id(first.find("shared/x"));
+  EXPECT_EQ(second.id(second.find("shared/x")), id);
+  EXPECT_EQ(second.find(id)->second, 3);
+
+  // interned by another map, but not part of this one
+  EXPECT_EQ(first.find(second.id(second.find("shared/y"))), first.end());
+  EXPECT_EQ(first.find("shared/y"), first.end());
+}
+
+TEST(SeriesMap, ReferencesAreStable)
+{
+  Map map;
+  int& first = add(map, "stable/0", 0)->second;
+  for (int i = 1; i < 1000; i++)
+  {
+    add(map, "stable/" + std::to_string(i), i);
+  }
+  first = -1;
+  EXPECT_EQ(map.find("stable/0")->second, -1);
+  EXPECT_EQ(&map.find("stable/0")->second, &first);
+}
+
+// ===========================================================================
+// Erase
+// ===========================================================================
+
+TEST(SeriesMap, EraseMovesTheLastElement)
+{
+  Map map;
+  for (int i = 0; i < 5; i++)
+  {
+    add(map, "erase/" + std::to_string(i), i);
+  }
+  const SeriesId id4 = map.id(map.find("erase/4"));
+  int* last = &map.find("erase/4")->second;
+
+  auto next = map.erase(map.find("erase/1"));
+  ASSERT_NE(next, map.end());
+  EXPECT_EQ(next->first, "erase/4");
+  EXPECT_EQ(&next->second, last);
+  EXPECT_EQ(map.size(), 4u);
+
+  EXPECT_EQ(map.find("erase/1"), map.end());
+  EXPECT_EQ(map.find("erase/4"), next);
+  EXPECT_EQ(map.find(id4), next);
+  for (int i : { 0, 2, 3, 4 })
+  {
+    EXPECT_EQ(map.find("erase/" + std::to_string(i))->second, i);
+  }
+
+  // erasing the last element
+  next = map.erase(map.find("erase/3"));
+  EXPECT_EQ(next, map.end());
+  EXPECT_EQ(map.erase("erase/3"), 0u);
+  EXPECT_EQ(map.erase("erase/0"), 1u);
+  EXPECT_EQ(map.size(), 2u);
+
+  // a name can be added again
+  add(map, "erase/1", 10);
+  EXPECT_EQ(map.find("erase/1")->second, 10);
+  EXPECT_EQ(map.size(), 3u);
+}
+
+TEST(SeriesMap, IterationAfterErase)
+{
+  Map map;
+  for (int i = 0; i < 10; i++)
+  {
+    add(map, "iter/" + std::to_string(i), i);
+  }
+  for (auto it = map.begin(); it != map.end();)
+  {
+    it = (it->second % 2 == 0) ? map.erase(it) : std::next(it);
+  }
+
+  int sum = 0;
+  for (const auto& [name, value] : map)
+  {
+    EXPECT_EQ(value % 2, 1);
+    EXPECT_EQ(map.find(name)->second, value);
+    sum += value;
+  }
+  EXPECT_EQ(sum, 1 + 3 + 5 + 7 + 9);
+  EXPECT_EQ(map.size(), 5u);
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.find("iter/1"), map.end());
+}
+
+// ===========================================================================
+// renameAll
+// ===========================================================================
+
+TEST(SeriesMap, RenameAll)
+{
+  Map map;
+  add(map, "old/a", 1);
+  add(map, "old/b", 2);
+  add(map, "old/c", 3);
+
+  map.renameAll([](const std::string& name) { return "new" + name.substr(3); });
+
+  EXPECT_EQ(map.size(), 3u);
+  EXPECT_EQ(map.find("old/a"), map.end());
+  std::string order;
+  for (const auto& [name, value] : map)
+  {
+    order += name.substr(4);
+    EXPECT_EQ(map.find(name)->second, value);
+    EXPECT_EQ(map.find(SeriesNames::instance()->find(name))->second, value);
+  }
+  EXPECT_EQ(order, "abc");
+}
+
+TEST(SeriesMap, RenameAllCollision)
+{
+  Map map;
+  add(map, "dup/a1", 1);
+  add(map, "dup/b", 2);
+  add(map, "dup/a2", 3);
+
+  // "dup/a1" and "dup/a2" become "dup/a": the last one wins
+  map.renameAll([](const std::string& name) {
+    return (name[4] == 'a') ? std::string("dup/a") : name;
+  });
+
+  EXPECT_EQ(map.size(), 2u);
+  EXPECT_EQ(map.find("dup/a")->second, 3);
+  EXPECT_EQ(map.find("dup/b")->second, 2);
+  EXPECT_EQ(map.begin()->first, "dup/a");
+
+  // the map is still consistent after the collision
+  EXPECT_EQ(map.erase("dup/a"), 1u);
+  EXPECT_EQ(map.find("dup/b")->second, 2);
+  EXPECT_EQ(map.find(map.id(map.find("dup/b")))->second, 2);
+}
@@ -0,0 +1,98 @@
+#include "PlotJuggler/spsc_queue.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+
+using namespace PJ;
+
+TEST(SPSCQueue, PushPopInOrder)
+{
+  SPSCQueue<int, 4> queue;
+  int value = -1;
+  EXPECT_FALSE(queue.pop(value));
+  EXPECT_EQ(value, -1);
+
+  for (int i = 0; i < 3; i++)
+  {
+    EXPECT_TRUE(queue.push(int(i)));
+  }
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SPSCQueue, FullQueueKeepsTheValue)
+{
+  SPSCQueue<std::unique_ptr<int>, 2> queue;
+  EXPECT_TRUE(queue.push(std::make_unique<int>(0)));
+  EXPECT_TRUE(queue.push(std::make_unique<int>(1)));
+
+  auto rejected = std::make_unique<int>(2);
+  EXPECT_FALSE(queue.push(std::move(rejected)));
+  ASSERT_NE(rejected, nullptr);
+  EXPECT_EQ(*rejected, 2);
+
+  std::unique_ptr<int> value;
+  ASSERT_TRUE(queue.pop(value));
+  EXPECT_EQ(*value, 0);
+  // the free slot can be used again
+  EXPECT_TRUE(queue.push(std::move(rejected)));
+  ASSERT_TRUE(queue.pop(value));
+  EXPECT_EQ(*value, 1);
+  ASSERT_TRUE(queue.pop(value));
+  EXPECT_EQ(*value, 2);
+  EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(SPSCQueue, WrapAround)
+{
+  SPSCQueue<size_t, 8> queue;
+  size_t value = 0;
+  // the indexes go around the buffer many times, with 5 elements in the queue
+  for (size_t i = 0; i < 4; i++)
+  {
+    ASSERT_TRUE(queue.push(size_t(i)));
+  }
+  for (size_t i = 4; i < 100; i++)
+  {
+    ASSERT_TRUE(queue.push(size_t(i)));
+    ASSERT_TRUE(queue.pop(value));
+    EXPECT_EQ(value, i - 4);
+  }
+}
+
+TEST(SPSCQueue, TwoThreads)
+{
+  constexpr size_t COUNT = 200000;
+  SPSCQueue<size_t, 64> queue;
+
+  std::thread producer([&queue]() {
+    for (size_t i = 0; i < COUNT; i++)
+    {
+      while (!queue.push(size_t(i)))
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  size_t expected = 0;
+  size_t value = 0;
+  while (expected < COUNT)
+  {
+    if (queue.pop(value))
+    {
+      ASSERT_EQ(value, expected);
+      expected++;
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  EXPECT_FALSE(queue.pop(value));
+}
@@ -11,7 +11,6 @@
 #include <QMessageBox>
 #include <QDebug>
 #include <QSettings>
-#include <QProgressDialog>
 #include <QDateTime>
 #include <QInputDialog>
 #include <QPushButton>
@@ -230,8 +229,9 @@ bool DataLoadMCAP::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_dat
     throw std::runtime_error("No parsing available");
   }
 
-  // open file
-  mcap::McapReader reader;
+  // open file. The reader is shared with the background job
+  auto reader_ptr = std::make_shared<mcap::McapReader>();
+  mcap::McapReader& reader = *reader_ptr;
   auto status = reader.open(info->filename.toStdString());
   if (!status.ok())
   {
@@ -448,75 +448,80 @@ bool DataLoadMCAP::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_dat
 
   //-------------------------------------------
   //---------------- Parse messages -----------
+  // This is the slow part: it is executed by the application in a worker thread.
 
-  auto onProblem = [](const mcap::Status& problem) {
-    qDebug() << QString::fromStdString(problem.message);
-  };
+  const bool use_mcap_log_time = _dialog_parameters->use_mcap_log_time;
+  const mcap::ByteOffset summary_start = summaryInfo.summaryStart;
 
-  // When selective summary was used, readSummary() was not called, so
-  // reader.dataEnd_ still includes the summary section. Construct
-  // LinearMessageView with explicit byte range to avoid reading expensive
-  // summary records during iteration.
-  auto createMessageView = [&]() -> mcap::LinearMessageView {
-    if (usedSelectiveSummary)
-    {
-      auto [dataStart, dataEndUnused] = reader.byteRange(0);
-      return mcap::LinearMessageView(reader, dataStart, summaryInfo.summaryStart, 0, mcap::MaxTime,
-                                     onProblem);
-    }
-    return reader.readMessages(onProblem);
-  };
+  setBackgroundJob([reader_ptr, usedSelectiveSummary, summary_start, use_mcap_log_time,
+                    parsers_by_channel, enabled_channels, total_msgs, timer](LoadingTask& task) {
+    mcap::McapReader& reader = *reader_ptr;
 
-  auto messages = createMessageView();
+    auto onProblem = [](const mcap::Status& problem) {
+      qDebug() << QString::fromStdString(problem.message);
+    };
 
-  QProgressDialog progress_dialog("Loading... please wait", "Cancel", 0, 0, nullptr);
-  progress_dialog.setWindowTitle("Loading the MCAP file");
-  progress_dialog.setWindowModality(Qt::ApplicationModal);
-  progress_dialog.setRange(0, std::max<size_t>(total_msgs, 1) - 1);
-  progress_dialog.show();
-  progress_dialog.setValue(0);
+    // When selective summary was used, readSummary() was not called, so
+    // reader.dataEnd_ still includes the summary section. Construct
+    // LinearMessageView with explicit byte range to avoid reading expensive
+    // summary records during iteration.
+    auto createMessageView = [&]() -> mcap::LinearMessageView {
+      if (usedSelectiveSummary)
+      {
+        auto [dataStart, dataEndUnused] = reader.byteRange(0);
+        return mcap::LinearMessageView(reader, dataStart, summary_start, 0, mcap::MaxTime,
+                                       onProblem);
+      }
+      return reader.readMessages(onProblem);
+    };
 
-  size_t msg_count = 0;
+    auto messages = createMessageView();
 
-  auto new_progress_update = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    size_t msg_count = 0;
+    task.setProgress(0, total_msgs);
 
-  for (const auto& msg_view : messages)
-  {
-    if (enabled_channels.count(msg_view.channel->id) == 0)
+    for (const auto& msg_view : messages)
     {
-      continue;
-    }
+      if (enabled_channels.count(msg_view.channel->id) == 0)
+      {
+        continue;
+      }
 
-    // MCAP always represents publishTime in nanoseconds
-    double timestamp_sec = double(msg_view.message.publishTime) * 1e-9;
-    if (_dialog_parameters->use_mcap_log_time)
-    {
-      timestamp_sec = double(msg_view.message.logTime) * 1e-9;
-    }
-    auto parser_it = parsers_by_channel.find(msg_view.channel->id);
-    if (parser_it == parsers_by_channel.end())
-    {
-      qDebug() << "Skipping channeld id: " << msg_view.channel->id;
-      continue;
-    }
+      // MCAP always represents publishTime in nanoseconds
+      double timestamp_sec = double(msg_view.message.publishTime) * 1e-9;
+      if (use_mcap_log_time)
+      {
+        timestamp_sec = double(msg_view.message.logTime) * 1e-9;
+      }
+      auto parser_it = parsers_by_channel.find(msg_view.channel->id);
+      if (parser_it == parsers_by_channel.end())
+      {
+        qDebug() << "Skipping channeld id: " << msg_view.channel->id;
+        continue;
+      }
 
-    auto parser = parser_it->second;
-    MessageRef msg(msg_view.message.data, msg_view.message.dataSize);
-    parser->parseMessage(msg, timestamp_sec);
+      auto parser = parser_it->second;
+      MessageRef msg(msg_view.message.data, msg_view.message.dataSize);
+      {
+        // the application reads the points loaded so far, while we are parsing
+        std::lock_guard<std::mutex> lock(task.mutex());
+        parser->parseMessage(msg, timestamp_sec);
+      }
 
-    if (msg_count++ % 100 == 0 && std::chrono::steady_clock::now() > new_progress_update)
-    {
-      new_progress_update += std::chrono::milliseconds(500);
-      progress_dialog.setValue(msg_count);
-      QApplication::processEvents();
-      if (progress_dialog.wasCanceled())
+      if (msg_count++ % 100 == 0)
       {
-        break;
+        task.setProgress(msg_count, total_msgs);
+        if (task.isCanceled())
+        {
+          // keep the messages parsed so far, see DataLoader::BackgroundJob
+          break;
+        }
       }
     }
-  }
 
-  reader.close();
-  qDebug() << "Loaded file in " << timer.elapsed() << "milliseconds";
+    reader.close();
+    qDebug() << "Loaded file in " << timer.elapsed() << "milliseconds";
+    return true;
+  });
   return true;
 }
@@ -140,6 +140,32 @@ double get_arrow_value(const std::shared_ptr<arrow::Array>& array, int64_t index
   return std::numeric_limits<double>::quiet_NaN();
 }
 
+// native type of a numeric series, used to store the values with the same width
+PJ::BuiltinType ToValueType(arrow::Type::type arrow_type)
+{
+  switch (arrow_type)
+  {
+    case arrow::Type::BOOL:
+      return PJ::BuiltinType::BOOL;
+    case arrow::Type::INT8:
+      return PJ::BuiltinType::INT8;
+    case arrow::Type::INT16:
+      return PJ::BuiltinType::INT16;
+    case arrow::Type::INT32:
+      return PJ::BuiltinType::INT32;
+    case arrow::Type::UINT8:
+      return PJ::BuiltinType::UINT8;
+    case arrow::Type::UINT16:
+      return PJ::BuiltinType::UINT16;
+    case arrow::Type::UINT32:
+      return PJ::BuiltinType::UINT32;
+    case arrow::Type::FLOAT:
+      return PJ::BuiltinType::FLOAT32;
+    default:
+      return PJ::BuiltinType::FLOAT64;
+  }
+}
+
 bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_data)
 {
   // Open the file using Arrow IO
@@ -204,6 +230,7 @@ bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_
     if (is_valid)
     {
       info.plot_data = &plot_data.getOrCreateNumeric(info.name, nullptr);
+      info.plot_data->setValueType(ToValueType(info.arrow_type));
       columns_info.push_back(info);
     }
 
@@ -305,6 +332,15 @@ bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_
     std::sort(timestamp_to_row_index.begin(), timestamp_to_row_index.end(),
               [](const auto& a, const auto& b) { return a.first < b.first; });
 
+    // the same timestamps are used by all the columns of the batch
+    std::vector<double> timestamps(batch_rows);
+    for (int64_t row = 0; row < batch_rows; row++)
+    {
+      timestamps[row] = (timestamp_column >= 0) ? timestamp_to_row_index[row].first :
+                                                  static_cast<double>(rows_processed + row);
+    }
+    std::vector<double> values(batch_rows);
+
     int column = 0;
 
     for (const auto& info : columns_info)
@@ -313,19 +349,12 @@ bool DataLoadParquet::readDataFromFile(FileLoadInfo* info, PlotDataMapRef& plot_
 
       for (int64_t row = 0; row < batch_rows; row++)
       {
-        size_t ordered_row = row;
-        double timestamp = static_cast<double>(rows_processed + row);
-        if (timestamp_column >= 0)
-        {
-          timestamp = timestamp_to_row_index[row].first;
-          ordered_row = timestamp_to_row_index[row].second;
-        }
-        double value = get_arrow_value(values_array, ordered_row, info.arrow_type);
-        if (!std::isnan(value))
-        {
-          info.plot_data->pushBack({ timestamp, value });
-        }
+        const size_t ordered_row =
+            (timestamp_column >= 0) ? timestamp_to_row_index[row].second : size_t(row);
+        values[row] = get_arrow_value(values_array, ordered_row, info.arrow_type);
       }
+      // NaN values (i.e. nulls) are skipped
+      info.plot_data->appendSorted(timestamps.data(), values.data(), values.size());
 
       if (column++ % 10 == 0)
       {
@@ -6,10 +6,38 @@
 #include <QWidget>
 #include <QSettings>
 #include <QMainWindow>
+#include <algorithm>
 
 #include "ulog_parser.h"
 #include "ulog_parameters_dialog.h"
 
+// native type of a numeric series, used to store the values with the same width
+static PJ::BuiltinType ToValueType(ULogParser::FormatType type)
+{
+  switch (type)
+  {
+    case ULogParser::BOOL:
+      return PJ::BuiltinType::BOOL;
+    case ULogParser::UINT8:
+      return PJ::BuiltinType::UINT8;
+    case ULogParser::CHAR:
+    case ULogParser::INT8:
+      return PJ::BuiltinType::INT8;
+    case ULogParser::UINT16:
+      return PJ::BuiltinType::UINT16;
+    case ULogParser::INT16:
+      return PJ::BuiltinType::INT16;
+    case ULogParser::UINT32:
+      return PJ::BuiltinType::UINT32;
+    case ULogParser::INT32:
+      return PJ::BuiltinType::INT32;
+    case ULogParser::FLOAT:
+      return PJ::BuiltinType::FLOAT32;
+    default:
+      return PJ::BuiltinType::FLOAT64;
+  }
+}
+
 DataLoadULog::DataLoadULog() : _main_win(nullptr)
 {
   for (QWidget* widget : qApp->topLevelWidgets())
@@ -30,59 +58,93 @@ const std::vector<const char*>& DataLoadULog::compatibleFileExtensions() const
 
 bool DataLoadULog::readDataFromFile(FileLoadInfo* fileload_info, PlotDataMapRef& plot_data)
 {
-  const auto& filename = fileload_info->filename;
+  const QString filename = fileload_info->filename;
+  QWidget* main_win = _main_win;
 
-  QFile file(filename);
+  // nothing to configure: the entire file is parsed by the background job
+  setBackgroundJob([this, filename, main_win, &plot_data](LoadingTask& task) {
+    QFile file(filename);
 
-  if (!file.open(QIODevice::ReadOnly))
-  {
-    throw std::runtime_error("ULog: Failed to open file");
-  }
-  QByteArray file_array = file.readAll();
-  ULogParser::DataStream datastream(file_array.data(), file_array.size());
+    if (!file.open(QIODevice::ReadOnly))
+    {
+      throw std::runtime_error("ULog: Failed to open file");
+    }
+    QByteArray file_array = file.readAll();
+    ULogParser::DataStream datastream(file_array.data(), file_array.size());
 
-  ULogParser parser(datastream);
+    // shared with the dialog, that is created later in the GUI thread
+    auto parser = std::make_shared<ULogParser>(datastream);
 
-  const auto& timeseries_map = parser.getTimeseriesMap();
-  auto min_msg_time = std::numeric_limits<double>::max();
-  for (const auto& it : timeseries_map)
-  {
-    const std::string& sucsctiption_name = it.first;
-    const ULogParser::Timeseries& timeseries = it.second;
-    auto group = plot_data.getOrCreateGroup(sucsctiption_name);
+    const auto& timeseries_map = parser->getTimeseriesMap();
+    auto min_msg_time = std::numeric_limits<double>::max();
+    size_t done = 0;
+    task.setProgress(done, timeseries_map.size());
 
-    for (const auto& data : timeseries.data)
+    for (const auto& it : timeseries_map)
     {
-      std::string series_name = sucsctiption_name + data.first;
-
-      auto series = plot_data.addNumeric(series_name, group);
+      if (task.isCanceled())
+      {
+        // keep the subscriptions loaded so far, see DataLoader::BackgroundJob
+        return true;
+      }
+      const std::string& sucsctiption_name = it.first;
+      const ULogParser::Timeseries& timeseries = it.second;
 
-      for (size_t i = 0; i < data.second.size(); i++)
+      // all the fields of the subscription share the same timestamps
+      std::vector<double> msg_times(timeseries.timestamps.size());
+      for (size_t i = 0; i < msg_times.size(); i++)
       {
-        assert(i < timeseries.timestamps.size());
         const uint64_t timestamp = timeseries.timestamps[i].value_or(static_cast<uint64_t>(i));
-        double msg_time = static_cast<double>(timestamp) * 0.000001;
-        min_msg_time = std::min(min_msg_time, msg_time);
-        PlotData::Point point(msg_time, data.second[i]);
-        series->second.pushBack(point);
+        msg_times[i] = static_cast<double>(timestamp) * 0.000001;
+      }
+
+      std::lock_guard<std::mutex> lock(task.mutex());
+      auto group = plot_data.getOrCreateGroup(sucsctiption_name);
+
+      for (size_t index = 0; index < timeseries.data.size(); index++)
+      {
+        const auto& data = timeseries.data[index];
+        std::string series_name = sucsctiption_name + data.first;
+
+        auto series = plot_data.addNumeric(series_name, group);
+        series->second.setValueType(ToValueType(timeseries.types[index]));
+
+        const size_t count = data.second.size();
+        assert(count <= msg_times.size());
+        if (count > 0)
+        {
+          auto first_time = std::min_element(msg_times.begin(), msg_times.begin() + count);
+          min_msg_time = std::min(min_msg_time, *first_time);
+        }
+        series->second.appendSorted(msg_times.data(), data.second.data(), count);
       }
+      task.setProgress(++done, timeseries_map.size());
     }
-  }
 
-  // store parameters as a timeseries with a single point
-  for (const auto& param : parser.getParameters())
-  {
-    auto series = plot_data.addNumeric("_parameters/" + param.name);
-    double value = (param.val_type == ULogParser::FLOAT) ? double(param.value.val_real) :
-                                                           double(param.value.val_int);
-    series->second.pushBack({ min_msg_time, value });
-  }
+    {
+      // store parameters as a timeseries with a single point
+      std::lock_guard<std::mutex> lock(task.mutex());
+      for (const auto& param : parser->getParameters())
+      {
+        auto series = plot_data.addNumeric("_parameters/" + param.name);
+        double value = (param.val_type == ULogParser::FLOAT) ? double(param.value.val_real) :
+                                                               double(param.value.val_int);
+        series->second.pushBack({ min_msg_time, value });
+      }
+    }
 
-  ULogParametersDialog* dialog = new ULogParametersDialog(parser, _main_win);
-  dialog->setWindowTitle(QString("ULog file %1").arg(filename));
-  dialog->setAttribute(Qt::WA_DeleteOnClose);
-  dialog->restoreSettings();
-  dialog->show();
+    QMetaObject::invokeMethod(
+        this,
+        [parser, filename, main_win]() {
+          ULogParametersDialog* dialog = new ULogParametersDialog(*parser, main_win);
+          dialog->setWindowTitle(QString("ULog file %1").arg(filename));
+          dialog->setAttribute(Qt::WA_DeleteOnClose);
+          dialog->restoreSettings();
+          dialog->show();
+        },
+        Qt::QueuedConnection);
+    return true;
+  });
 
   return true;
 }
@@ -802,6 +802,7 @@ ULogParser::Timeseries ULogParser::createTimeseries(const ULogParser::Format* fo
         if (field.type != OTHER)
         {
           timeseries.data.push_back({ new_prefix + array_suffix, std::vector<double>() });
+          timeseries.types.push_back(field.type);
         }
         else
         {
@@ -124,6 +124,8 @@ public:
   {
     std::vector<std::optional<uint64_t>> timestamps;
     std::vector<std::pair<std::string, std::vector<double>>> data;
+    // original type of each element of data
+    std::vector<FormatType> types;
   };
 
 public:
@@ -139,7 +139,7 @@ bool DataStreamZMQ::start(QStringList*)
   topics = dialog->ui->lineEditTopics->text();
   _is_connect = dialog->ui->radioConnect->isChecked();
 
-  _parser = _parser_creator->createParser({}, {}, {}, dataMap());
+  _parser = _parser_creator->createParser({}, {}, {}, ingestBuffer());
 
   // save back to service
   settings.setValue("ZMQ_Subscriber::address", address);
@@ -165,7 +165,7 @@ bool DataStreamZMQ::start(QStringList*)
   // Add a parser for each topic
   for (const auto& topic : _topic_filters)
   {
-    _parsers[topic] = _parser_creator->createParser(topic, {}, {}, dataMap());
+    _parsers[topic] = _parser_creator->createParser(topic, {}, {}, ingestBuffer());
   }
 
   _zmq_socket.set(zmq::sockopt::rcvtimeo, 100);
@@ -205,6 +205,25 @@ void DataStreamZMQ::shutdown()
 
 void DataStreamZMQ::receiveLoop()
 {
+  // The messages are parsed into ingestBuffer(), without locking mutex(), and
+  // the new points are published in batches, at most every PUBLISH_PERIOD.
+  constexpr auto PUBLISH_PERIOD = std::chrono::milliseconds(20);
+  auto last_publish = std::chrono::steady_clock::now();
+  bool pending_data = false;
+
+  auto publishData = [&](bool force) {
+    const auto now = std::chrono::steady_clock::now();
+    if (pending_data && (force || now - last_publish >= PUBLISH_PERIOD))
+    {
+      last_publish = now;
+      if (publishIngestBuffer())
+      {
+        pending_data = false;
+        emit this->dataReceived();
+      }
+    }
+  };
+
   while (_running)
   {
     zmq::message_t recv_msg;
@@ -213,6 +232,7 @@ void DataStreamZMQ::receiveLoop()
     // If we did not receive anything, continue
     if (recv_msg.size() <= 0)
     {
+      publishData(true);
       continue;
     }
 
@@ -262,19 +282,14 @@ void DataStreamZMQ::receiveLoop()
     // Parse the message without a topic if it is empty
     if (topic.empty())
     {
-      if (parseMessage(msg, timestamp))
-      {
-        emit this->dataReceived();
-      }
+      pending_data |= parseMessage(msg, timestamp);
     }
     // Otherwise, parse the message with the topic
     else
     {
-      if (parseMessage(topic, msg, timestamp))
-      {
-        emit this->dataReceived();
-      }
+      pending_data |= parseMessage(topic, msg, timestamp);
     }
+    publishData(false);
 
     // Extinguish remaining parts (if any)
     while (recv_msg.more())
@@ -283,13 +298,13 @@ void DataStreamZMQ::receiveLoop()
       result = _zmq_socket.recv(recv_msg);
     }
   }
+  publishData(true);
 }
 
 bool DataStreamZMQ::parseMessage(const PJ::MessageRef& msg, double& timestamp)
 {
   try
   {
-    std::lock_guard<std::mutex> lock(mutex());
     _parser->parseMessage(msg, timestamp);
     return true;
   }
@@ -304,11 +319,10 @@ bool DataStreamZMQ::parseMessage(const std::string& topic, const PJ::MessageRef&
 {
   try
   {
-    std::lock_guard<std::mutex> lock(mutex());
     // If the topic is not in the map keys, create a new parser
     if (_parsers.find(topic) == _parsers.end())
     {
-      _parsers[topic] = _parser_creator->createParser(topic, {}, {}, dataMap());
+      _parsers[topic] = _parser_creator->createParser(topic, {}, {}, ingestBuffer());
     }
 
     _parsers[topic]->parseMessage(msg, timestamp);
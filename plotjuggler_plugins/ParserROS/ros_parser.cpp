@@ -12,6 +12,37 @@
 using namespace PJ;
 using namespace RosMsgParser;
 
+// PJ::BuiltinType and RosMsgParser::BuiltinType would be ambiguous
+using RosType = RosMsgParser::BuiltinType;
+
+// native type of a numeric series, used to store the values with the same width
+static PJ::BuiltinType ToValueType(RosType type)
+{
+  switch (type)
+  {
+    case RosType::BOOL:
+      return PJ::BuiltinType::BOOL;
+    case RosType::BYTE:
+    case RosType::UINT8:
+      return PJ::BuiltinType::UINT8;
+    case RosType::CHAR:
+    case RosType::INT8:
+      return PJ::BuiltinType::INT8;
+    case RosType::UINT16:
+      return PJ::BuiltinType::UINT16;
+    case RosType::INT16:
+      return PJ::BuiltinType::INT16;
+    case RosType::UINT32:
+      return PJ::BuiltinType::UINT32;
+    case RosType::INT32:
+      return PJ::BuiltinType::INT32;
+    case RosType::FLOAT32:
+      return PJ::BuiltinType::FLOAT32;
+    default:
+      return PJ::BuiltinType::FLOAT64;
+  }
+}
+
 static ROSType quaternion_type(Msg::Quaternion::id());
 constexpr double RAD_TO_DEG = 180.0 / M_PI;
 
@@ -131,29 +162,41 @@ bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timest
     timestamp = (ts > 0) ? ts : timestamp;
   }
 
-  std::string series_name;
-
-  for (const auto& [key, str] : _flat_msg.name)
+  for (size_t i = 0; i < _flat_msg.name.size(); i++)
   {
-    key.toStr(series_name);
-    StringSeries& data = getStringSeries(series_name);
+    const auto& [key, str] = _flat_msg.name[i];
+    FieldHandle* cached = cachedField(_name_handles, i, key);
+    if (cached->handle == PJ::INVALID_SERIES_ID)
+    {
+      cached->handle = registerStringSeries(key.toStdString());
+    }
+    StringSeries& data = getStringSeries(cached->handle);
     data.pushBack({ timestamp, str });
   }
 
-  for (const auto& [key, value] : _flat_msg.value)
+  for (size_t i = 0; i < _flat_msg.value.size(); i++)
   {
-    key.toStr(series_name);
-    PlotData& data = getSeries(series_name);
+    const auto& [key, value] = _flat_msg.value[i];
+    FieldHandle* cached = cachedField(_value_handles, i, key);
+    if (cached->handle == PJ::INVALID_SERIES_ID)
+    {
+      cached->handle = registerSeries(key.toStdString());
+    }
+    PlotData& data = getSeries(cached->handle);
+    if (data.size() == 0)
+    {
+      data.setValueType(ToValueType(value.getTypeID()));
+    }
 
     if (!_strict_truncation_check)
     {
       // bypass the truncation check
-      if (value.getTypeID() == BuiltinType::INT64)
+      if (value.getTypeID() == RosType::INT64)
       {
         data.pushBack({ timestamp, double(value.convert<int64_t>()) });
         continue;
       }
-      if (value.getTypeID() == BuiltinType::UINT64)
+      if (value.getTypeID() == RosType::UINT64)
       {
         data.pushBack({ timestamp, double(value.convert<uint64_t>()) });
         continue;
@@ -177,6 +220,28 @@ bool ParserROS::parseMessage(const PJ::MessageRef serialized_msg, double& timest
   return true;
 }
 
+ParserROS::FieldHandle* ParserROS::cachedField(std::vector<FieldHandle>& cache, size_t index,
+                                               const RosMsgParser::FieldsVector& field)
+{
+  if (index >= cache.size())
+  {
+    cache.resize(index + 1);
+  }
+  FieldHandle& cached = cache[index];
+  // comparing the pointers to the fields of the schema is much cheaper than
+  // building and hashing the name of the series
+  if (cached.handle != PJ::INVALID_SERIES_ID &&
+      (cached.field.fields != field.fields || cached.field.index_array != field.index_array))
+  {
+    cached.handle = PJ::INVALID_SERIES_ID;
+  }
+  if (cached.handle == PJ::INVALID_SERIES_ID)
+  {
+    cached.field = field;
+  }
+  return &cached;
+}
+
 void ParserROS::setLargeArraysPolicy(bool clamp, unsigned max_size)
 {
   auto policy =
@@ -511,7 +576,7 @@ void ParserROS::parseDataTamerSchemas(const std::string& prefix, double& timesta
   for (size_t i = 0; i < vector_size; i++)
   {
     DataTamerParser::Schema schema;
-    schema.hash = _deserializer->deserialize(BuiltinType::UINT64).convert<uint64_t>();
+    schema.hash = _deserializer->deserialize(RosType::UINT64).convert<uint64_t>();
     std::string channel_name;
     _deserializer->deserializeString(channel_name);
     std::string schema_text;
@@ -527,8 +592,8 @@ void ParserROS::parseDataTamerSnapshot(const std::string& prefix, double& timest
 {
   DataTamerParser::SnapshotView snapshot;
 
-  snapshot.timestamp = _deserializer->deserialize(BuiltinType::UINT64).convert<uint64_t>();
-  snapshot.schema_hash = _deserializer->deserialize(BuiltinType::UINT64).convert<uint64_t>();
+  snapshot.timestamp = _deserializer->deserialize(RosType::UINT64).convert<uint64_t>();
+  snapshot.schema_hash = _deserializer->deserialize(RosType::UINT64).convert<uint64_t>();
 
   auto active_mask = _deserializer->deserializeByteSequence();
   snapshot.active_mask = { active_mask.data(), active_mask.size() };
@@ -582,7 +647,7 @@ void ParserROS::parsePalStatisticsValues(const std::string& prefix, double& time
 
   for (auto& value : values)
   {
-    value = _deserializer->deserialize(BuiltinType::FLOAT64).convert<double>();
+    value = _deserializer->deserialize(RosType::FLOAT64).convert<double>();
   }
   uint32_t names_version = _deserializer->deserializeUInt32();
   auto it = _pal_statistics_names_per_topic[parsed_prefix].find(names_version);
@@ -614,10 +679,10 @@ std::string ParserROS::parsePalStatisticsPrefix(const std::string& in_prefix)
   return prefix;
 }
 
-constexpr static std::array<BuiltinType, 11> _tsl_type_order = {
-  BuiltinType::BOOL,   BuiltinType::INT8,    BuiltinType::UINT8,   BuiltinType::INT16,
-  BuiltinType::UINT16, BuiltinType::INT32,   BuiltinType::UINT32,  BuiltinType::INT64,
-  BuiltinType::UINT64, BuiltinType::FLOAT32, BuiltinType::FLOAT64,
+constexpr static std::array<RosType, 11> _tsl_type_order = {
+  RosType::BOOL,   RosType::INT8,    RosType::UINT8,   RosType::INT16,
+  RosType::UINT16, RosType::INT32,   RosType::UINT32,  RosType::INT64,
+  RosType::UINT64, RosType::FLOAT32, RosType::FLOAT64,
 };
 static std::unordered_map<std::uint64_t, std::vector<std::string>> _tsl_definitions;
 // Add a buffer for messages that are received before their definition
@@ -643,7 +708,7 @@ void ParserROS::parseTSLDefinition(const std::string& prefix, double& timestamp)
   std::uint32_t sec = _deserializer->deserializeUInt32();   // stamp
   std::uint32_t nsec = _deserializer->deserializeUInt32();  // stamp
   std::size_t definition_hash =
-      _deserializer->deserialize(BuiltinType::UINT64).extract<std::size_t>();
+      _deserializer->deserialize(RosType::UINT64).extract<std::size_t>();
 
   // Return if definition has already been parsed
   if (_tsl_definitions.count(definition_hash) != 0)
@@ -687,7 +752,7 @@ void ParserROS::parseTSLValues(const std::string& prefix, double& timestamp)
   std::uint32_t sec = _deserializer->deserializeUInt32();   // stamp
   std::uint32_t nsec = _deserializer->deserializeUInt32();  // stamp
   std::size_t definition_hash =
-      _deserializer->deserialize(BuiltinType::UINT64).extract<std::size_t>();
+      _deserializer->deserialize(RosType::UINT64).extract<std::size_t>();
 
   // Create the definition
   std::vector<double> values;
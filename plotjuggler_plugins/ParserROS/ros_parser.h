@@ -72,6 +72,19 @@ protected:
 
   std::function<void(const std::string& prefix, double&)> _customized_parser;
 
+  // Series of the fields of _flat_msg, in the same order. Unless the message contains
+  // arrays of variable size, the fields are the same in every message.
+  struct FieldHandle
+  {
+    RosMsgParser::FieldsVector field;
+    SeriesHandle handle = PJ::INVALID_SERIES_ID;
+  };
+  std::vector<FieldHandle> _value_handles;
+  std::vector<FieldHandle> _name_handles;
+
+  FieldHandle* cachedField(std::vector<FieldHandle>& cache, size_t index,
+                           const RosMsgParser::FieldsVector& field);
+
   bool _has_header = false;
   bool _strict_truncation_check = true;
 };